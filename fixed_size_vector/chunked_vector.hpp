@@ -0,0 +1,627 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+namespace detail {
+// Random access iterator over a chunked_vector. It indexes the chunk table
+// directly, so it stays valid until the table itself grows.
+template <typename T, std::size_t ChunkCapacity, bool IsConst>
+class chunked_iterator {
+  using chunk_type =
+      std::conditional_t<IsConst, const fixed_size_vector<T, ChunkCapacity>,
+                         fixed_size_vector<T, ChunkCapacity>>;
+  using table_pointer = chunk_type *const *;
+
+  public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<IsConst, const T &, T &>;
+  using pointer = std::conditional_t<IsConst, const T *, T *>;
+
+  chunked_iterator() = default;
+  chunked_iterator(table_pointer table, std::size_t pos)
+      : table{table}, pos{pos} {}
+  template <bool OtherConst,
+            typename = std::enable_if_t<IsConst && !OtherConst>>
+  chunked_iterator(
+      const chunked_iterator<T, ChunkCapacity, OtherConst> &other)
+      : table{other.table}, pos{other.pos} {}
+
+  reference operator*() const {
+    return (*table[pos / ChunkCapacity])[pos % ChunkCapacity];
+  }
+  pointer operator->() const { return &**this; }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  chunked_iterator &operator++() {
+    ++pos;
+    return *this;
+  }
+  chunked_iterator operator++(int) {
+    chunked_iterator copy{*this};
+    ++pos;
+    return copy;
+  }
+  chunked_iterator &operator--() {
+    --pos;
+    return *this;
+  }
+  chunked_iterator operator--(int) {
+    chunked_iterator copy{*this};
+    --pos;
+    return copy;
+  }
+  chunked_iterator &operator+=(difference_type n) {
+    pos += n;
+    return *this;
+  }
+  chunked_iterator &operator-=(difference_type n) {
+    pos -= n;
+    return *this;
+  }
+  friend chunked_iterator operator+(chunked_iterator iter, difference_type n) {
+    return iter += n;
+  }
+  friend chunked_iterator operator+(difference_type n, chunked_iterator iter) {
+    return iter += n;
+  }
+  friend chunked_iterator operator-(chunked_iterator iter, difference_type n) {
+    return iter -= n;
+  }
+  friend difference_type operator-(const chunked_iterator &lhs,
+                                   const chunked_iterator &rhs) {
+    return static_cast<difference_type>(lhs.pos) -
+           static_cast<difference_type>(rhs.pos);
+  }
+  friend bool operator==(const chunked_iterator &lhs,
+                         const chunked_iterator &rhs) {
+    return lhs.pos == rhs.pos;
+  }
+  friend bool operator!=(const chunked_iterator &lhs,
+                         const chunked_iterator &rhs) {
+    return lhs.pos != rhs.pos;
+  }
+  friend bool operator<(const chunked_iterator &lhs,
+                        const chunked_iterator &rhs) {
+    return lhs.pos < rhs.pos;
+  }
+  friend bool operator>(const chunked_iterator &lhs,
+                        const chunked_iterator &rhs) {
+    return lhs.pos > rhs.pos;
+  }
+  friend bool operator<=(const chunked_iterator &lhs,
+                         const chunked_iterator &rhs) {
+    return lhs.pos <= rhs.pos;
+  }
+  friend bool operator>=(const chunked_iterator &lhs,
+                         const chunked_iterator &rhs) {
+    return lhs.pos >= rhs.pos;
+  }
+
+  std::size_t index() const { return pos; }
+
+  private:
+  template <typename, std::size_t, bool>
+  friend class chunked_iterator;
+
+  table_pointer table{nullptr};
+  std::size_t pos{0};
+};
+}  // namespace detail
+
+// Growable sequence made of fixed_size_vector<T, ChunkCapacity> blocks.
+// Appending never moves existing elements, so references and pointers stay
+// valid until their element is removed; only the table of chunk pointers is
+// reallocated, which invalidates iterators. Chunks emptied by pop_back or
+// clear are kept in a pool and reused before new ones are allocated.
+template <typename T, std::size_t ChunkCapacity,
+          typename Allocator = std::allocator<T>>
+class chunked_vector {
+  static_assert(ChunkCapacity > 0, "chunks must hold at least one element");
+
+  public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using allocator_type = Allocator;
+  using reference = T &;
+  using const_reference = const T &;
+  using chunk_type = fixed_size_vector<T, ChunkCapacity>;
+  using iterator = detail::chunked_iterator<T, ChunkCapacity, false>;
+  using const_iterator = detail::chunked_iterator<T, ChunkCapacity, true>;
+
+  chunked_vector() = default;
+  explicit chunked_vector(const Allocator &allocator);
+  chunked_vector(std::initializer_list<value_type> initializer_list,
+                 const Allocator &allocator = Allocator{});
+  chunked_vector(const chunked_vector &other);
+  chunked_vector(chunked_vector &&other) noexcept;
+  chunked_vector &operator=(const chunked_vector &other);
+  chunked_vector &operator=(chunked_vector &&other) noexcept(
+      std::allocator_traits<Allocator>::propagate_on_container_move_assignment::
+          value ||
+      std::allocator_traits<Allocator>::is_always_equal::value);
+  ~chunked_vector();
+
+  static constexpr size_type chunk_capacity();
+  size_type size() const;
+  bool empty() const;
+  size_type capacity() const;
+  size_type chunk_count() const;
+  size_type pooled_chunk_count() const;
+
+  void push_back(const value_type &value);
+  void push_back(value_type &&value);
+  template <typename... Args>
+  reference emplace_back(Args &&... args);
+  void pop_back();
+  void clear();
+  void reserve(size_type count);
+  void shrink_to_fit();
+
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+
+  chunk_type &chunk(size_type pos);
+  const chunk_type &chunk(size_type pos) const;
+  template <typename Fn>
+  void for_each_chunk(Fn &&fn);
+  template <typename Fn>
+  void for_each_chunk(Fn &&fn) const;
+
+  void swap(chunked_vector &other) noexcept;
+
+  private:
+  using chunk_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<chunk_type>;
+  using table_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<chunk_type *>;
+  using chunk_table = std::vector<chunk_type *, table_allocator>;
+
+  chunk_allocator chunks_allocator;
+  chunk_table chunks;
+  chunk_table pool;
+  size_type current_size{0};
+
+  chunk_type &append_slot();
+  chunk_type *acquire_chunk();
+  chunk_type *allocate_chunk();
+  void deallocate_chunk(chunk_type *item);
+  void release_chunks();
+  void steal(chunked_vector &other) noexcept;
+};
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>::chunked_vector(
+    const Allocator &allocator)
+    : chunks_allocator{allocator},
+      chunks{table_allocator{allocator}},
+      pool{table_allocator{allocator}} {}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>::chunked_vector(
+    std::initializer_list<value_type> initializer_list,
+    const Allocator &allocator)
+    : chunked_vector(allocator) {
+  for (const auto &item : initializer_list) {
+    push_back(item);
+  }
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>::chunked_vector(
+    const chunked_vector &other)
+    : chunked_vector(std::allocator_traits<chunk_allocator>::
+                         select_on_container_copy_construction(
+                             other.chunks_allocator)) {
+  reserve(other.size());
+  for (const auto &item : other) {
+    push_back(item);
+  }
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>::chunked_vector(
+    chunked_vector &&other) noexcept
+    : chunks_allocator{other.chunks_allocator},
+      chunks{std::move(other.chunks)},
+      pool{std::move(other.pool)},
+      current_size{other.current_size} {
+  other.chunks.clear();
+  other.pool.clear();
+  other.current_size = 0;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>
+    &chunked_vector<T, ChunkCapacity, Allocator>::operator=(
+        const chunked_vector &other) {
+  if (this == &other) return *this;
+  clear();
+  reserve(other.size());
+  for (const auto &item : other) {
+    push_back(item);
+  }
+  return *this;
+}
+
+// Takes over the other vector's chunks when the allocator propagates or
+// compares equal. Otherwise the chunks belong to a different allocator, so
+// the elements are moved one by one into chunks allocated here.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>
+    &chunked_vector<T, ChunkCapacity, Allocator>::operator=(
+        chunked_vector &&other) noexcept(
+        std::allocator_traits<Allocator>::
+            propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value) {
+  if (this == &other) return *this;
+  using traits = std::allocator_traits<Allocator>;
+  if constexpr (traits::propagate_on_container_move_assignment::value) {
+    release_chunks();
+    chunks_allocator = std::move(other.chunks_allocator);
+    steal(other);
+  } else {
+    if (traits::is_always_equal::value ||
+        chunks_allocator == other.chunks_allocator) {
+      release_chunks();
+      steal(other);
+      return *this;
+    }
+    chunked_vector moved{Allocator(chunks_allocator)};
+    moved.reserve(other.size());
+    for (auto &item : other) {
+      moved.push_back(std::move(item));
+    }
+    release_chunks();
+    steal(moved);
+  }
+  return *this;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+chunked_vector<T, ChunkCapacity, Allocator>::~chunked_vector() {
+  release_chunks();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+constexpr typename chunked_vector<T, ChunkCapacity, Allocator>::size_type
+chunked_vector<T, ChunkCapacity, Allocator>::chunk_capacity() {
+  return ChunkCapacity;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::size_type
+chunked_vector<T, ChunkCapacity, Allocator>::size() const {
+  return current_size;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+bool chunked_vector<T, ChunkCapacity, Allocator>::empty() const {
+  return current_size == 0;
+}
+
+// Elements that fit without allocating, counting pooled chunks.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::size_type
+chunked_vector<T, ChunkCapacity, Allocator>::capacity() const {
+  return (chunks.size() + pool.size()) * ChunkCapacity;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::size_type
+chunked_vector<T, ChunkCapacity, Allocator>::chunk_count() const {
+  return chunks.size();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::size_type
+chunked_vector<T, ChunkCapacity, Allocator>::pooled_chunk_count() const {
+  return pool.size();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::push_back(
+    const value_type &value) {
+  append_slot().push_back(value);
+  ++current_size;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::push_back(
+    value_type &&value) {
+  append_slot().push_back(std::move(value));
+  ++current_size;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+template <typename... Args>
+typename chunked_vector<T, ChunkCapacity, Allocator>::reference
+chunked_vector<T, ChunkCapacity, Allocator>::emplace_back(Args &&... args) {
+  chunk_type &target = append_slot();
+  target.emplace_back(std::forward<Args>(args)...);
+  ++current_size;
+  return target.back();
+}
+
+// The emptied chunk is pooled before anything is removed, so a failure to
+// grow the pool leaves the vector unchanged.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::pop_back() {
+  chunk_type *last = chunks.back();
+  if (last->size() == 1) pool.push_back(last);
+  last->pop_back();
+  --current_size;
+  if (last->empty()) chunks.pop_back();
+}
+
+// Destroys every element and returns all chunks to the pool.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::clear() {
+  pool.reserve(pool.size() + chunks.size());
+  for (chunk_type *item : chunks) {
+    item->clear();
+    pool.push_back(item);
+  }
+  chunks.clear();
+  current_size = 0;
+}
+
+// Allocates enough pooled chunks that count elements fit without further
+// chunk allocations.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::reserve(
+    const size_type count) {
+  const size_type needed = (count + ChunkCapacity - 1) / ChunkCapacity;
+  chunks.reserve(needed);
+  if (chunks.size() + pool.size() < needed) {
+    pool.reserve(needed - chunks.size());
+  }
+  while (chunks.size() + pool.size() < needed) {
+    pool.push_back(allocate_chunk());
+  }
+}
+
+// Frees the pooled chunks and trims the chunk table.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::shrink_to_fit() {
+  for (chunk_type *item : pool) {
+    deallocate_chunk(item);
+  }
+  pool.clear();
+  pool.shrink_to_fit();
+  chunks.shrink_to_fit();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::reference
+    chunked_vector<T, ChunkCapacity, Allocator>::operator[](
+        const size_type pos) {
+  return (*chunks[pos / ChunkCapacity])[pos % ChunkCapacity];
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_reference
+    chunked_vector<T, ChunkCapacity, Allocator>::operator[](
+        const size_type pos) const {
+  return (*chunks[pos / ChunkCapacity])[pos % ChunkCapacity];
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::reference
+chunked_vector<T, ChunkCapacity, Allocator>::at(const size_type pos) {
+  if (pos >= current_size) throw std::out_of_range{""};
+  return (*this)[pos];
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_reference
+chunked_vector<T, ChunkCapacity, Allocator>::at(const size_type pos) const {
+  if (pos >= current_size) throw std::out_of_range{""};
+  return (*this)[pos];
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::reference
+chunked_vector<T, ChunkCapacity, Allocator>::front() {
+  return chunks.front()->front();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_reference
+chunked_vector<T, ChunkCapacity, Allocator>::front() const {
+  return chunks.front()->front();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::reference
+chunked_vector<T, ChunkCapacity, Allocator>::back() {
+  return chunks.back()->back();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_reference
+chunked_vector<T, ChunkCapacity, Allocator>::back() const {
+  return chunks.back()->back();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::iterator
+chunked_vector<T, ChunkCapacity, Allocator>::begin() {
+  return iterator{chunks.data(), 0};
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_iterator
+chunked_vector<T, ChunkCapacity, Allocator>::begin() const {
+  return const_iterator{chunks.data(), 0};
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_iterator
+chunked_vector<T, ChunkCapacity, Allocator>::cbegin() const {
+  return begin();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::iterator
+chunked_vector<T, ChunkCapacity, Allocator>::end() {
+  return iterator{chunks.data(), current_size};
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_iterator
+chunked_vector<T, ChunkCapacity, Allocator>::end() const {
+  return const_iterator{chunks.data(), current_size};
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::const_iterator
+chunked_vector<T, ChunkCapacity, Allocator>::cend() const {
+  return end();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::chunk_type &
+chunked_vector<T, ChunkCapacity, Allocator>::chunk(const size_type pos) {
+  return *chunks[pos];
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+const typename chunked_vector<T, ChunkCapacity, Allocator>::chunk_type &
+chunked_vector<T, ChunkCapacity, Allocator>::chunk(const size_type pos) const {
+  return *chunks[pos];
+}
+
+// Calls fn(data, count) once per chunk, in order. Each call sees a
+// contiguous run of elements, which lets scans vectorize inside a chunk.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+template <typename Fn>
+void chunked_vector<T, ChunkCapacity, Allocator>::for_each_chunk(Fn &&fn) {
+  for (chunk_type *item : chunks) {
+    fn(item->data(), item->size());
+  }
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+template <typename Fn>
+void chunked_vector<T, ChunkCapacity, Allocator>::for_each_chunk(
+    Fn &&fn) const {
+  for (const chunk_type *item : chunks) {
+    fn(item->data(), item->size());
+  }
+}
+
+// Allocators are exchanged only when they propagate on swap; otherwise they
+// must compare equal, as for the standard containers.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::swap(
+    chunked_vector &other) noexcept {
+  using std::swap;
+  if constexpr (std::allocator_traits<
+                    Allocator>::propagate_on_container_swap::value) {
+    swap(chunks_allocator, other.chunks_allocator);
+  }
+  chunks.swap(other.chunks);
+  pool.swap(other.pool);
+  swap(current_size, other.current_size);
+}
+
+// Returns the chunk the next element goes into, taking one from the pool or
+// the allocator when the last chunk is full. The chunk table grows
+// geometrically through push_back, so appends stay amortized O(1).
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::chunk_type &
+chunked_vector<T, ChunkCapacity, Allocator>::append_slot() {
+  if (current_size == chunks.size() * ChunkCapacity) {
+    chunk_type *item = acquire_chunk();
+    try {
+      chunks.push_back(item);
+    } catch (...) {
+      deallocate_chunk(item);
+      throw;
+    }
+  }
+  return *chunks.back();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::chunk_type *
+chunked_vector<T, ChunkCapacity, Allocator>::acquire_chunk() {
+  if (pool.empty()) return allocate_chunk();
+  chunk_type *item = pool.back();
+  pool.pop_back();
+  return item;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+typename chunked_vector<T, ChunkCapacity, Allocator>::chunk_type *
+chunked_vector<T, ChunkCapacity, Allocator>::allocate_chunk() {
+  chunk_type *item =
+      std::allocator_traits<chunk_allocator>::allocate(chunks_allocator, 1);
+  return new (item) chunk_type;
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::deallocate_chunk(
+    chunk_type *item) {
+  item->~chunk_type();
+  std::allocator_traits<chunk_allocator>::deallocate(chunks_allocator, item, 1);
+}
+
+// Destroys and frees every chunk, in use or pooled, without touching the
+// allocator of either table, so it cannot throw.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::release_chunks() {
+  for (chunk_type *item : chunks) {
+    deallocate_chunk(item);
+  }
+  for (chunk_type *item : pool) {
+    deallocate_chunk(item);
+  }
+  chunks.clear();
+  pool.clear();
+  current_size = 0;
+}
+
+// Both tables are moved with allocators that propagate or compare equal, so
+// the moves only exchange buffers.
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void chunked_vector<T, ChunkCapacity, Allocator>::steal(
+    chunked_vector &other) noexcept {
+  chunks = std::move(other.chunks);
+  pool = std::move(other.pool);
+  current_size = std::exchange(other.current_size, 0);
+  other.chunks.clear();
+  other.pool.clear();
+}
+
+template <typename T, std::size_t ChunkCapacity, typename Allocator>
+void swap(chunked_vector<T, ChunkCapacity, Allocator> &lhs,
+          chunked_vector<T, ChunkCapacity, Allocator> &rhs) noexcept {
+  lhs.swap(rhs);
+}
+}  // namespace utils
@@ -0,0 +1,220 @@
+#pragma once
+#if __has_include(<version>)
+#include <version>
+#elif __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+
+// fixed_size_arena lets std::pmr containers allocate from inline storage,
+// typically on the stack of a request handler:
+//
+//   utils::fixed_size_arena<4096> arena;
+//   std::pmr::vector<int> ids{&arena};
+namespace utils {
+// Whether a fixed_size_arena hands freed blocks out again.
+enum class arena_reuse {
+  monotonic,    // freed memory is only reclaimed by release()
+  size_classes  // freed blocks up to max_size_class are recycled
+};
+
+struct arena_statistics {
+  std::size_t allocations;           // requests served from inline storage
+  std::size_t deallocations;         // blocks handed back to inline storage
+  std::size_t recycled;              // allocations served from a free list
+  std::size_t peak_bytes;            // highest bump offset reached
+  std::size_t upstream_allocations;  // requests passed to the upstream
+  std::size_t upstream_bytes;        // bytes requested from the upstream
+};
+
+// std::pmr::memory_resource that bump-allocates from Bytes of inline storage
+// aligned to Align. Requests that do not fit go to the upstream resource:
+// the heap by default, or std::pmr::null_memory_resource() to fail fast
+// with std::bad_alloc. Freeing the most recent block rolls the bump pointer
+// back. With arena_reuse::size_classes, small requests are rounded up to a
+// power of two and freed blocks are kept on per-class free lists.
+template <std::size_t Bytes, std::size_t Align = alignof(std::max_align_t)>
+class fixed_size_arena : public std::pmr::memory_resource {
+  static_assert(Bytes > 0, "the arena needs some inline storage");
+  static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+                "Align must be a power of two");
+
+  public:
+  using size_type = std::size_t;
+
+  static constexpr size_type min_size_class{16};
+  static constexpr size_type max_size_class{4096};
+
+  explicit fixed_size_arena(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource(),
+      arena_reuse reuse = arena_reuse::monotonic);
+  explicit fixed_size_arena(arena_reuse reuse);
+  fixed_size_arena(const fixed_size_arena &) = delete;
+  fixed_size_arena &operator=(const fixed_size_arena &) = delete;
+
+  static constexpr size_type capacity();
+  size_type used() const;
+  size_type remaining() const;
+  bool owns(const void *p) const;
+  const arena_statistics &statistics() const;
+  std::pmr::memory_resource *upstream_resource() const;
+
+  void release();
+
+  protected:
+  void *do_allocate(size_type bytes, size_type alignment) override;
+  void do_deallocate(void *p, size_type bytes, size_type alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override;
+
+  private:
+  static constexpr size_type class_count{10};  // 16 .. 4096 bytes
+
+  alignas(Align) unsigned char buffer[Bytes];
+  size_type offset{0};
+  std::pmr::memory_resource *upstream;
+  arena_reuse reuse;
+  void *free_lists[class_count]{};
+  arena_statistics stats{};
+
+  static size_type size_class(size_type bytes);
+  void *bump(size_type bytes, size_type alignment);
+};
+
+template <std::size_t Bytes, std::size_t Align>
+fixed_size_arena<Bytes, Align>::fixed_size_arena(
+    std::pmr::memory_resource *upstream, const arena_reuse reuse)
+    : upstream{upstream}, reuse{reuse} {}
+
+template <std::size_t Bytes, std::size_t Align>
+fixed_size_arena<Bytes, Align>::fixed_size_arena(const arena_reuse reuse)
+    : fixed_size_arena(std::pmr::new_delete_resource(), reuse) {}
+
+template <std::size_t Bytes, std::size_t Align>
+constexpr typename fixed_size_arena<Bytes, Align>::size_type
+fixed_size_arena<Bytes, Align>::capacity() {
+  return Bytes;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+typename fixed_size_arena<Bytes, Align>::size_type
+fixed_size_arena<Bytes, Align>::used() const {
+  return offset;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+typename fixed_size_arena<Bytes, Align>::size_type
+fixed_size_arena<Bytes, Align>::remaining() const {
+  return Bytes - offset;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+bool fixed_size_arena<Bytes, Align>::owns(const void *p) const {
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+  const auto base = reinterpret_cast<std::uintptr_t>(buffer);
+  return address >= base && address < base + Bytes;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+const arena_statistics &fixed_size_arena<Bytes, Align>::statistics() const {
+  return stats;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+std::pmr::memory_resource *fixed_size_arena<Bytes, Align>::upstream_resource()
+    const {
+  return upstream;
+}
+
+// Forgets every inline allocation at once. Blocks obtained from the
+// upstream are not tracked and must still be deallocated by their owners.
+template <std::size_t Bytes, std::size_t Align>
+void fixed_size_arena<Bytes, Align>::release() {
+  offset = 0;
+  for (void *&head : free_lists) {
+    head = nullptr;
+  }
+}
+
+template <std::size_t Bytes, std::size_t Align>
+void *fixed_size_arena<Bytes, Align>::do_allocate(size_type bytes,
+                                                  const size_type alignment) {
+  const size_type requested = bytes;
+  if (bytes == 0) bytes = 1;
+  if (reuse == arena_reuse::size_classes && bytes <= max_size_class) {
+    const size_type index = size_class(bytes);
+    bytes = min_size_class << index;
+    void *head = free_lists[index];
+    if (head != nullptr &&
+        reinterpret_cast<std::uintptr_t>(head) % alignment == 0) {
+      std::memcpy(&free_lists[index], head, sizeof(void *));
+      ++stats.allocations;
+      ++stats.recycled;
+      return head;
+    }
+  }
+  if (void *p = bump(bytes, alignment)) {
+    ++stats.allocations;
+    return p;
+  }
+  void *p = upstream->allocate(requested, alignment);
+  ++stats.upstream_allocations;
+  stats.upstream_bytes += requested;
+  return p;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+void fixed_size_arena<Bytes, Align>::do_deallocate(void *p, size_type bytes,
+                                                   const size_type alignment) {
+  if (!owns(p)) {
+    upstream->deallocate(p, bytes, alignment);
+    return;
+  }
+  ++stats.deallocations;
+  if (bytes == 0) bytes = 1;
+  if (reuse == arena_reuse::size_classes && bytes <= max_size_class) {
+    const size_type index = size_class(bytes);
+    std::memcpy(p, &free_lists[index], sizeof(void *));
+    free_lists[index] = p;
+    return;
+  }
+  if (static_cast<unsigned char *>(p) + bytes == buffer + offset) {
+    offset -= bytes;
+  }
+}
+
+template <std::size_t Bytes, std::size_t Align>
+bool fixed_size_arena<Bytes, Align>::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+// Index of the smallest power-of-two class, starting at min_size_class,
+// that holds bytes.
+template <std::size_t Bytes, std::size_t Align>
+typename fixed_size_arena<Bytes, Align>::size_type
+fixed_size_arena<Bytes, Align>::size_class(const size_type bytes) {
+  size_type index{0};
+  while ((min_size_class << index) < bytes) ++index;
+  return index;
+}
+
+template <std::size_t Bytes, std::size_t Align>
+void *fixed_size_arena<Bytes, Align>::bump(const size_type bytes,
+                                           const size_type alignment) {
+  const auto base = reinterpret_cast<std::uintptr_t>(buffer);
+  const std::uintptr_t top = base + offset;
+  const size_type start =
+      static_cast<size_type>(((top + alignment - 1) & ~(alignment - 1)) - base);
+  if (start > Bytes || bytes > Bytes - start) return nullptr;
+  offset = start + bytes;
+  if (offset > stats.peak_bytes) stats.peak_bytes = offset;
+  return buffer + start;
+}
+}  // namespace utils
+#endif
@@ -0,0 +1,583 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "fixed_size_simd.hpp"
+
+namespace utils {
+namespace detail {
+// Proxy for a single bit, returned where fixed_size_vector returns T&.
+class bit_reference {
+  public:
+  bit_reference(std::uint64_t *word, std::uint64_t mask)
+      : word{word}, mask{mask} {}
+  bit_reference(const bit_reference &) = default;
+
+  operator bool() const { return (*word & mask) != 0; }
+  bit_reference &operator=(bool value) {
+    if (value) {
+      *word |= mask;
+    } else {
+      *word &= ~mask;
+    }
+    return *this;
+  }
+  bit_reference &operator=(const bit_reference &other) {
+    return *this = static_cast<bool>(other);
+  }
+  void flip() { *word ^= mask; }
+
+  private:
+  std::uint64_t *word;
+  std::uint64_t mask;
+};
+
+// Random access iterator over packed bits. Const iterators yield bool,
+// mutable ones yield bit_reference.
+template <bool IsConst>
+class bit_iterator {
+  using word_pointer =
+      std::conditional_t<IsConst, const std::uint64_t *, std::uint64_t *>;
+
+  public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = bool;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<IsConst, bool, bit_reference>;
+  using pointer = void;
+
+  bit_iterator() = default;
+  bit_iterator(word_pointer words, std::size_t pos)
+      : words{words}, pos{pos} {}
+  template <bool OtherConst,
+            typename = std::enable_if_t<IsConst && !OtherConst>>
+  bit_iterator(const bit_iterator<OtherConst> &other)
+      : words{other.words}, pos{other.pos} {}
+
+  reference operator*() const {
+    if constexpr (IsConst) {
+      return (words[pos / 64] >> (pos % 64)) & 1u;
+    } else {
+      return bit_reference{words + pos / 64, std::uint64_t{1} << (pos % 64)};
+    }
+  }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  bit_iterator &operator++() {
+    ++pos;
+    return *this;
+  }
+  bit_iterator operator++(int) {
+    bit_iterator copy{*this};
+    ++pos;
+    return copy;
+  }
+  bit_iterator &operator--() {
+    --pos;
+    return *this;
+  }
+  bit_iterator operator--(int) {
+    bit_iterator copy{*this};
+    --pos;
+    return copy;
+  }
+  bit_iterator &operator+=(difference_type n) {
+    pos += n;
+    return *this;
+  }
+  bit_iterator &operator-=(difference_type n) {
+    pos -= n;
+    return *this;
+  }
+  friend bit_iterator operator+(bit_iterator iter, difference_type n) {
+    return iter += n;
+  }
+  friend bit_iterator operator+(difference_type n, bit_iterator iter) {
+    return iter += n;
+  }
+  friend bit_iterator operator-(bit_iterator iter, difference_type n) {
+    return iter -= n;
+  }
+  friend difference_type operator-(const bit_iterator &lhs,
+                                   const bit_iterator &rhs) {
+    return static_cast<difference_type>(lhs.pos) -
+           static_cast<difference_type>(rhs.pos);
+  }
+  friend bool operator==(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos == rhs.pos;
+  }
+  friend bool operator!=(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos != rhs.pos;
+  }
+  friend bool operator<(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos < rhs.pos;
+  }
+  friend bool operator>(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos > rhs.pos;
+  }
+  friend bool operator<=(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos <= rhs.pos;
+  }
+  friend bool operator>=(const bit_iterator &lhs, const bit_iterator &rhs) {
+    return lhs.pos >= rhs.pos;
+  }
+
+  std::size_t index() const { return pos; }
+
+  private:
+  template <bool>
+  friend class bit_iterator;
+
+  word_pointer words{nullptr};
+  std::size_t pos{0};
+};
+}  // namespace detail
+
+// Vector of up to Capacity bools packed 64 per word. Bits at and past size()
+// are always zero, so count, rank and the bitwise operators work on whole
+// words without masking the tail.
+template <std::size_t Capacity>
+class fixed_size_bitvector {
+  public:
+  using value_type = bool;
+  using size_type = std::size_t;
+  using reference = detail::bit_reference;
+  using const_reference = bool;
+  using iterator = detail::bit_iterator<false>;
+  using const_iterator = detail::bit_iterator<true>;
+
+  static constexpr size_type npos{static_cast<size_type>(-1)};
+
+  fixed_size_bitvector() = default;
+  fixed_size_bitvector(std::initializer_list<bool> initializer_list);
+
+  static constexpr size_type capacity();
+  static constexpr size_type max_size();
+  size_type size() const;
+  bool empty() const;
+
+  void push_back(bool value);
+  void pop_back();
+  iterator insert(const_iterator pos, bool value);
+  iterator erase(const_iterator pos);
+  void clear();
+
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+  bool test(size_type pos) const;
+  void set(size_type pos, bool value = true);
+  void flip(size_type pos);
+
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+
+  size_type count() const;
+  bool any() const;
+  bool none() const;
+  size_type find_first() const;
+  size_type find_next(size_type pos) const;
+  size_type rank(size_type pos) const;
+  size_type select(size_type rank) const;
+
+  fixed_size_bitvector &operator&=(const fixed_size_bitvector &other);
+  fixed_size_bitvector &operator|=(const fixed_size_bitvector &other);
+  fixed_size_bitvector &operator^=(const fixed_size_bitvector &other);
+
+  const std::uint64_t *words() const;
+  static constexpr size_type word_count();
+
+  private:
+  static constexpr size_type bits_per_word{64};
+  static constexpr size_type words_size{(Capacity + bits_per_word - 1) /
+                                        bits_per_word};
+  static constexpr size_type storage_words{words_size == 0 ? 1 : words_size};
+  std::uint64_t storage[storage_words]{};
+  size_type current_size{0};
+
+  size_type used_words() const;
+};
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity>::fixed_size_bitvector(
+    std::initializer_list<bool> initializer_list) {
+  for (bool value : initializer_list) {
+    push_back(value);
+  }
+}
+
+template <std::size_t Capacity>
+constexpr typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::capacity() {
+  return Capacity;
+}
+
+template <std::size_t Capacity>
+constexpr typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::max_size() {
+  return Capacity;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::size() const {
+  return current_size;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_bitvector<Capacity>::empty() const {
+  return current_size == 0u;
+}
+
+template <std::size_t Capacity>
+void fixed_size_bitvector<Capacity>::push_back(const bool value) {
+  if (current_size == Capacity) throw std::bad_alloc{};
+  storage[current_size / bits_per_word] |= std::uint64_t{value}
+                                           << (current_size % bits_per_word);
+  ++current_size;
+}
+
+template <std::size_t Capacity>
+void fixed_size_bitvector<Capacity>::pop_back() {
+  --current_size;
+  storage[current_size / bits_per_word] &=
+      ~(std::uint64_t{1} << (current_size % bits_per_word));
+}
+
+// Bits from pos upwards move up by one, carrying each word's top bit into
+// the next word.
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::iterator
+fixed_size_bitvector<Capacity>::insert(const_iterator pos, const bool value) {
+  if (current_size == Capacity) throw std::bad_alloc{};
+  const size_type index = pos.index();
+  const size_type first_word = index / bits_per_word;
+  // current_size < Capacity here, so the clamp only tells the compiler
+  // that the top word is in bounds.
+  const size_type last_word =
+      std::min(current_size / bits_per_word, storage_words - 1);
+  for (size_type word = last_word; word > first_word; --word) {
+    storage[word] = (storage[word] << 1) | (storage[word - 1] >> 63);
+  }
+  const std::uint64_t low_mask =
+      (std::uint64_t{1} << (index % bits_per_word)) - 1;
+  const std::uint64_t word = storage[first_word];
+  storage[first_word] = (word & low_mask) | ((word & ~low_mask) << 1) |
+                        (std::uint64_t{value} << (index % bits_per_word));
+  ++current_size;
+  return iterator{storage, index};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::iterator
+fixed_size_bitvector<Capacity>::erase(const_iterator pos) {
+  const size_type index = pos.index();
+  const size_type first_word = index / bits_per_word;
+  const size_type last_word =
+      std::min((current_size - 1) / bits_per_word, storage_words - 1);
+  const std::uint64_t low_mask =
+      (std::uint64_t{1} << (index % bits_per_word)) - 1;
+  const std::uint64_t word = storage[first_word];
+  storage[first_word] = (word & low_mask) | ((word >> 1) & ~low_mask);
+  for (size_type next = first_word + 1; next <= last_word; ++next) {
+    storage[next - 1] |= (storage[next] & 1u) << 63;
+    storage[next] >>= 1;
+  }
+  --current_size;
+  return iterator{storage, index};
+}
+
+template <std::size_t Capacity>
+void fixed_size_bitvector<Capacity>::clear() {
+  for (size_type word = 0; word < used_words(); ++word) {
+    storage[word] = 0;
+  }
+  current_size = 0;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::reference
+    fixed_size_bitvector<Capacity>::operator[](const size_type pos) {
+  return reference{storage + pos / bits_per_word,
+                   std::uint64_t{1} << (pos % bits_per_word)};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_reference
+    fixed_size_bitvector<Capacity>::operator[](const size_type pos) const {
+  return test(pos);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::reference
+fixed_size_bitvector<Capacity>::at(const size_type pos) {
+  if (pos >= current_size) throw std::out_of_range{""};
+  return (*this)[pos];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_reference
+fixed_size_bitvector<Capacity>::at(const size_type pos) const {
+  if (pos >= current_size) throw std::out_of_range{""};
+  return test(pos);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::reference
+fixed_size_bitvector<Capacity>::front() {
+  return (*this)[0];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_reference
+fixed_size_bitvector<Capacity>::front() const {
+  return test(0);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::reference
+fixed_size_bitvector<Capacity>::back() {
+  return (*this)[current_size - 1];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_reference
+fixed_size_bitvector<Capacity>::back() const {
+  return test(current_size - 1);
+}
+
+template <std::size_t Capacity>
+bool fixed_size_bitvector<Capacity>::test(const size_type pos) const {
+  return (storage[pos / bits_per_word] >> (pos % bits_per_word)) & 1u;
+}
+
+template <std::size_t Capacity>
+void fixed_size_bitvector<Capacity>::set(const size_type pos,
+                                         const bool value) {
+  (*this)[pos] = value;
+}
+
+template <std::size_t Capacity>
+void fixed_size_bitvector<Capacity>::flip(const size_type pos) {
+  (*this)[pos].flip();
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::iterator
+fixed_size_bitvector<Capacity>::begin() {
+  return iterator{storage, 0};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_iterator
+fixed_size_bitvector<Capacity>::begin() const {
+  return const_iterator{storage, 0};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_iterator
+fixed_size_bitvector<Capacity>::cbegin() const {
+  return const_iterator{storage, 0};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::iterator
+fixed_size_bitvector<Capacity>::end() {
+  return iterator{storage, current_size};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_iterator
+fixed_size_bitvector<Capacity>::end() const {
+  return const_iterator{storage, current_size};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::const_iterator
+fixed_size_bitvector<Capacity>::cend() const {
+  return const_iterator{storage, current_size};
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::count() const {
+  size_type total{0};
+  for (size_type word = 0; word < used_words(); ++word) {
+    total += detail::popcount64(storage[word]);
+  }
+  return total;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_bitvector<Capacity>::any() const {
+  return find_first() != npos;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_bitvector<Capacity>::none() const {
+  return find_first() == npos;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::find_first() const {
+  for (size_type word = 0; word < used_words(); ++word) {
+    if (storage[word] != 0) {
+      return word * bits_per_word +
+             detail::count_trailing_zeros64(storage[word]);
+    }
+  }
+  return npos;
+}
+
+// Returns the first set bit after pos, or npos.
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::find_next(const size_type pos) const {
+  const size_type next = pos + 1;
+  if (next >= current_size) return npos;
+  size_type word = next / bits_per_word;
+  std::uint64_t bits = storage[word] & (~std::uint64_t{0}
+                                        << (next % bits_per_word));
+  for (;;) {
+    if (bits != 0) {
+      return word * bits_per_word + detail::count_trailing_zeros64(bits);
+    }
+    if (++word == used_words()) return npos;
+    bits = storage[word];
+  }
+}
+
+// Number of set bits in [0, pos).
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::rank(const size_type pos) const {
+  const size_type full_words = pos / bits_per_word;
+  size_type total{0};
+  for (size_type word = 0; word < full_words; ++word) {
+    total += detail::popcount64(storage[word]);
+  }
+  if (pos % bits_per_word != 0) {
+    const std::uint64_t mask =
+        (std::uint64_t{1} << (pos % bits_per_word)) - 1;
+    total += detail::popcount64(storage[full_words] & mask);
+  }
+  return total;
+}
+
+// Position of the rank-th (0-based) set bit, or npos if there are fewer.
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::select(size_type rank) const {
+  for (size_type word = 0; word < used_words(); ++word) {
+    const size_type ones = detail::popcount64(storage[word]);
+    if (rank < ones) {
+      return word * bits_per_word +
+             detail::select64(storage[word], static_cast<unsigned>(rank));
+    }
+    rank -= ones;
+  }
+  return npos;
+}
+
+// The bitwise operators extend the shorter operand with zero bits; the
+// result is as long as the longer one. The loops run over whole words and
+// are left to the compiler to vectorize.
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> &fixed_size_bitvector<Capacity>::operator&=(
+    const fixed_size_bitvector &other) {
+  for (size_type word = 0; word < words_size; ++word) {
+    storage[word] &= other.storage[word];
+  }
+  if (other.current_size > current_size) current_size = other.current_size;
+  return *this;
+}
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> &fixed_size_bitvector<Capacity>::operator|=(
+    const fixed_size_bitvector &other) {
+  for (size_type word = 0; word < words_size; ++word) {
+    storage[word] |= other.storage[word];
+  }
+  if (other.current_size > current_size) current_size = other.current_size;
+  return *this;
+}
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> &fixed_size_bitvector<Capacity>::operator^=(
+    const fixed_size_bitvector &other) {
+  for (size_type word = 0; word < words_size; ++word) {
+    storage[word] ^= other.storage[word];
+  }
+  if (other.current_size > current_size) current_size = other.current_size;
+  return *this;
+}
+
+template <std::size_t Capacity>
+const std::uint64_t *fixed_size_bitvector<Capacity>::words() const {
+  return storage;
+}
+
+template <std::size_t Capacity>
+constexpr typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::word_count() {
+  return words_size;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_bitvector<Capacity>::size_type
+fixed_size_bitvector<Capacity>::used_words() const {
+  return (current_size + bits_per_word - 1) / bits_per_word;
+}
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> operator&(
+    fixed_size_bitvector<Capacity> lhs,
+    const fixed_size_bitvector<Capacity> &rhs) {
+  return lhs &= rhs;
+}
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> operator|(
+    fixed_size_bitvector<Capacity> lhs,
+    const fixed_size_bitvector<Capacity> &rhs) {
+  return lhs |= rhs;
+}
+
+template <std::size_t Capacity>
+fixed_size_bitvector<Capacity> operator^(
+    fixed_size_bitvector<Capacity> lhs,
+    const fixed_size_bitvector<Capacity> &rhs) {
+  return lhs ^= rhs;
+}
+
+template <std::size_t Capacity>
+bool operator==(const fixed_size_bitvector<Capacity> &lhs,
+                const fixed_size_bitvector<Capacity> &rhs) {
+  return lhs.size() == rhs.size() &&
+         detail::equal_bytes(lhs.words(), rhs.words(),
+                             fixed_size_bitvector<Capacity>::word_count() *
+                                 sizeof(std::uint64_t));
+}
+
+template <std::size_t Capacity>
+bool operator!=(const fixed_size_bitvector<Capacity> &lhs,
+                const fixed_size_bitvector<Capacity> &rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace utils
@@ -0,0 +1,233 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+// Priority queue kept as a 4-ary heap in fixed_size_vector storage. With the
+// default std::less, top() is the largest element, like std::priority_queue.
+// A node's children are adjacent, so a sift-down step usually touches a
+// single cache line instead of two.
+template <typename T, std::size_t Capacity, typename Compare = std::less<T>>
+class fixed_size_priority_queue {
+  public:
+  using container_type = fixed_size_vector<T, Capacity>;
+  using value_compare = Compare;
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+
+  fixed_size_priority_queue() = default;
+  explicit fixed_size_priority_queue(const Compare &compare);
+  template <typename InputIt>
+  fixed_size_priority_queue(InputIt first, InputIt last,
+                            const Compare &compare = Compare{});
+
+  static constexpr size_type capacity();
+  size_type size() const;
+  bool empty() const;
+  bool full() const;
+
+  const_reference top() const;
+  void push(const value_type &value);
+  void push(value_type &&value);
+  template <typename... Args>
+  void emplace(Args &&... args);
+  void pop();
+  void replace_top(value_type value);
+  bool push_bounded(value_type value);
+  template <typename OutputIt>
+  OutputIt drain_sorted(OutputIt out);
+
+  void clear();
+  void swap(fixed_size_priority_queue &other) noexcept(
+      std::is_nothrow_swappable_v<container_type> &&
+      std::is_nothrow_swappable_v<Compare>);
+
+  private:
+  static constexpr size_type arity{4};
+  container_type heap;
+  Compare comp{};
+
+  void make_heap();
+  void sift_up(size_type pos);
+  void sift_down(size_type pos);
+};
+
+template <typename T, std::size_t Capacity, typename Compare>
+fixed_size_priority_queue<T, Capacity, Compare>::fixed_size_priority_queue(
+    const Compare &compare)
+    : comp{compare} {}
+
+template <typename T, std::size_t Capacity, typename Compare>
+template <typename InputIt>
+fixed_size_priority_queue<T, Capacity, Compare>::fixed_size_priority_queue(
+    InputIt first, InputIt last, const Compare &compare)
+    : comp{compare} {
+  for (InputIt iter = first; iter != last; ++iter) {
+    if (heap.size() == Capacity) throw std::bad_alloc{};
+    heap.emplace_back(*iter);
+  }
+  make_heap();
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+constexpr typename fixed_size_priority_queue<T, Capacity, Compare>::size_type
+fixed_size_priority_queue<T, Capacity, Compare>::capacity() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+typename fixed_size_priority_queue<T, Capacity, Compare>::size_type
+fixed_size_priority_queue<T, Capacity, Compare>::size() const {
+  return heap.size();
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+bool fixed_size_priority_queue<T, Capacity, Compare>::empty() const {
+  return heap.empty();
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+bool fixed_size_priority_queue<T, Capacity, Compare>::full() const {
+  return heap.size() == Capacity;
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+typename fixed_size_priority_queue<T, Capacity, Compare>::const_reference
+fixed_size_priority_queue<T, Capacity, Compare>::top() const {
+  return heap.front();
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::push(
+    const value_type &value) {
+  emplace(value);
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::push(
+    value_type &&value) {
+  emplace(std::move(value));
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+template <typename... Args>
+void fixed_size_priority_queue<T, Capacity, Compare>::emplace(
+    Args &&... args) {
+  if (full()) throw std::bad_alloc{};
+  heap.emplace_back(std::forward<Args>(args)...);
+  sift_up(heap.size() - 1);
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::pop() {
+  if (heap.size() > 1) heap.front() = std::move(heap.back());
+  heap.pop_back();
+  if (!heap.empty()) sift_down(0);
+}
+
+// Equivalent to pop() followed by push(value), with a single sift-down.
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::replace_top(
+    value_type value) {
+  heap.front() = std::move(value);
+  sift_down(0);
+}
+
+// Keeps at most Capacity elements: once full, value displaces top() only if
+// top() compares after it, i.e. the queue retains the Capacity elements that
+// would be popped last. Use std::greater to keep the K largest of a stream.
+// Returns false if value was rejected.
+template <typename T, std::size_t Capacity, typename Compare>
+bool fixed_size_priority_queue<T, Capacity, Compare>::push_bounded(
+    value_type value) {
+  if (!full()) {
+    emplace(std::move(value));
+    return true;
+  }
+  if (Capacity == 0 || !comp(value, heap.front())) return false;
+  replace_top(std::move(value));
+  return true;
+}
+
+// Pops every element into out, top() first, leaving the queue empty.
+template <typename T, std::size_t Capacity, typename Compare>
+template <typename OutputIt>
+OutputIt fixed_size_priority_queue<T, Capacity, Compare>::drain_sorted(
+    OutputIt out) {
+  while (!heap.empty()) {
+    *out = std::move(heap.front());
+    ++out;
+    pop();
+  }
+  return out;
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::clear() {
+  heap.clear();
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::swap(
+    fixed_size_priority_queue &other) noexcept(
+    std::is_nothrow_swappable_v<container_type> &&
+    std::is_nothrow_swappable_v<Compare>) {
+  heap.swap(other.heap);
+  using std::swap;
+  swap(comp, other.comp);
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::make_heap() {
+  if (heap.size() < 2) return;
+  for (size_type pos = (heap.size() - 2) / arity + 1; pos-- > 0;) {
+    sift_down(pos);
+  }
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::sift_up(size_type pos) {
+  value_type value{std::move(heap[pos])};
+  while (pos > 0) {
+    const size_type parent = (pos - 1) / arity;
+    if (!comp(heap[parent], value)) break;
+    heap[pos] = std::move(heap[parent]);
+    pos = parent;
+  }
+  heap[pos] = std::move(value);
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void fixed_size_priority_queue<T, Capacity, Compare>::sift_down(
+    size_type pos) {
+  const size_type count = heap.size();
+  value_type value{std::move(heap[pos])};
+  for (;;) {
+    const size_type first_child = pos * arity + 1;
+    if (first_child >= count) break;
+    const size_type last_child = std::min(first_child + arity, count);
+    size_type best = first_child;
+    for (size_type child = first_child + 1; child < last_child; ++child) {
+      if (comp(heap[best], heap[child])) best = child;
+    }
+    if (!comp(value, heap[best])) break;
+    heap[pos] = std::move(heap[best]);
+    pos = best;
+  }
+  heap[pos] = std::move(value);
+}
+
+template <typename T, std::size_t Capacity, typename Compare>
+void swap(fixed_size_priority_queue<T, Capacity, Compare> &lhs,
+          fixed_size_priority_queue<T, Capacity, Compare> &rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+}  // namespace utils
@@ -0,0 +1,245 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define FIXED_SIZE_VECTOR_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FIXED_SIZE_VECTOR_HAS_SSE2 1
+#endif
+#if defined(__BMI2__) && (defined(__x86_64__) || defined(_M_X64))
+#define FIXED_SIZE_VECTOR_HAS_BMI2 1
+#endif
+
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2) || \
+    defined(FIXED_SIZE_VECTOR_HAS_AVX2) || defined(FIXED_SIZE_VECTOR_HAS_BMI2)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Byte-level kernels shared by the fixed-size containers. Each one has a
+// scalar fallback, so callers never need to check the feature macros.
+namespace utils {
+namespace detail {
+inline unsigned count_trailing_zeros(std::uint32_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+// Undefined for zero, like the TZCNT/BSF instructions it compiles to.
+inline unsigned count_trailing_zeros64(std::uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+  const auto low = static_cast<std::uint32_t>(value);
+  return low != 0 ? count_trailing_zeros(low)
+                  : 32 + count_trailing_zeros(
+                             static_cast<std::uint32_t>(value >> 32));
+#else
+  return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+inline unsigned popcount64(std::uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+  return static_cast<unsigned>(__popcnt64(value));
+#elif defined(_MSC_VER)
+  value = value - ((value >> 1) & 0x5555555555555555ULL);
+  value = (value & 0x3333333333333333ULL) +
+          ((value >> 2) & 0x3333333333333333ULL);
+  value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<unsigned>((value * 0x0101010101010101ULL) >> 56);
+#else
+  return static_cast<unsigned>(__builtin_popcountll(value));
+#endif
+}
+
+// Position of the rank-th (0-based) set bit of value; rank must be smaller
+// than popcount64(value). BMI2 does it with one PDEP.
+inline unsigned select64(std::uint64_t value, unsigned rank) {
+#if defined(FIXED_SIZE_VECTOR_HAS_BMI2)
+  return count_trailing_zeros64(_pdep_u64(std::uint64_t{1} << rank, value));
+#else
+  for (; rank != 0; --rank) value &= value - 1;
+  return count_trailing_zeros64(value);
+#endif
+}
+
+// Returns the index of the first byte equal to value, or size if none is.
+inline std::size_t find_byte(const char *data, std::size_t size, char value) {
+  std::size_t pos{0};
+#if defined(FIXED_SIZE_VECTOR_HAS_AVX2)
+  const __m256i needle32 = _mm256_set1_epi8(value);
+  for (; pos + 32 <= size; pos += 32) {
+    const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    const auto mask = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle32)));
+    if (mask != 0) return pos + count_trailing_zeros(mask);
+  }
+#endif
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  const __m128i needle16 = _mm_set1_epi8(value);
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const auto mask = static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+    if (mask != 0) return pos + count_trailing_zeros(mask);
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (data[pos] == value) return pos;
+  }
+  return size;
+}
+
+inline bool equal_bytes(const void *lhs, const void *rhs, std::size_t size) {
+  const auto *l = static_cast<const unsigned char *>(lhs);
+  const auto *r = static_cast<const unsigned char *>(rhs);
+  std::size_t pos{0};
+#if defined(FIXED_SIZE_VECTOR_HAS_AVX2)
+  for (; pos + 32 <= size; pos += 32) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(l + pos));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + pos));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != -1) return false;
+  }
+#endif
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(l + pos));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(r + pos));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) return false;
+  }
+#endif
+  return pos == size || std::memcmp(l + pos, r + pos, size - pos) == 0;
+}
+
+// Returns the index of the first non-zero byte, or size if all are zero.
+inline std::size_t find_nonzero_byte(const unsigned char *data,
+                                     std::size_t size) {
+  std::size_t pos{0};
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const auto mask = static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+    if (mask != 0xFFFF) return pos + count_trailing_zeros(~mask);
+  }
+#endif
+  for (; pos + 8 <= size; pos += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data + pos, sizeof(word));
+    if (word != 0) break;
+  }
+  for (; pos < size; ++pos) {
+    if (data[pos] != 0) return pos;
+  }
+  return size;
+}
+
+// Bit i of the result is set when group[i] == value, for the 16 bytes at
+// group. Used to probe hash table control bytes a whole group at a time.
+inline std::uint32_t match_byte16(const unsigned char *group,
+                                  unsigned char value) {
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  const __m128i chunk =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+  std::uint32_t mask{0};
+  for (unsigned i = 0; i < 16; ++i) {
+    if (group[i] == value) mask |= std::uint32_t{1} << i;
+  }
+  return mask;
+#endif
+}
+
+// Copies with non-temporal stores, so a large destination that will not be
+// read again soon does not evict the caller's working set. Buffers smaller
+// than a few cache lines go through memcpy.
+inline void stream_copy(void *dst, const void *src, std::size_t size) {
+  auto *d = static_cast<unsigned char *>(dst);
+  const auto *s = static_cast<const unsigned char *>(src);
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  const std::size_t head =
+      (16 - reinterpret_cast<std::uintptr_t>(d) % 16) % 16;
+  if (size >= head + 64) {
+    std::memcpy(d, s, head);
+    d += head;
+    s += head;
+    size -= head;
+    for (; size >= 64; size -= 64, d += 64, s += 64) {
+      for (int lane = 0; lane < 4; ++lane) {
+        _mm_stream_si128(
+            reinterpret_cast<__m128i *>(d) + lane,
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(s) + lane));
+      }
+    }
+    _mm_sfence();
+  }
+#endif
+  if (size != 0) std::memcpy(d, s, size);
+}
+
+inline void prefetch_read(const void *p) {
+#if defined(FIXED_SIZE_VECTOR_HAS_SSE2)
+  _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+inline std::uint64_t mix64(std::uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+// Non-cryptographic hash over raw bytes, eight bytes per step. Each word is
+// folded into a 64-bit state with a multiply-rotate, and the result gets a
+// full avalanche so low bits are usable for bucketing. CRC32 is not used:
+// its state is 32 bits wide and linear, so collisions are easy to build.
+inline std::size_t hash_bytes(const void *data, std::size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  std::uint64_t hash{0x9e3779b97f4a7c15ULL ^ size};
+  std::size_t pos{0};
+  for (; pos + 8 <= size; pos += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + pos, sizeof(word));
+    hash = (hash ^ word) * 0x87c37b91114253d5ULL;
+    hash = (hash << 31) | (hash >> 33);
+  }
+  if (pos < size) {
+    std::uint64_t word{0};
+    std::memcpy(&word, bytes + pos, size - pos);
+    hash = (hash ^ word) * 0x4cf5ad432745937fULL;
+  }
+  return static_cast<std::size_t>(mix64(hash));
+}
+}  // namespace detail
+}  // namespace utils
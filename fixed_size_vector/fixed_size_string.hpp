@@ -0,0 +1,444 @@
+#pragma once
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "fixed_size_simd.hpp"
+
+namespace utils {
+// Inline string of at most Capacity characters. The byte after the buffer
+// stores the remaining capacity rather than the size, so a full string has a
+// zero there and stays null-terminated without spending an extra byte.
+// Unused characters are kept zeroed, which lets equality compare the whole
+// fixed-length buffer in SIMD-sized blocks.
+template <std::size_t Capacity>
+class fixed_size_string {
+  static_assert(Capacity <= 255,
+                "fixed_size_string keeps its size in a single byte");
+
+  public:
+  using value_type = char;
+  using size_type = std::size_t;
+  using iterator = char *;
+  using const_iterator = const char *;
+  using reference = char &;
+  using const_reference = const char &;
+  using pointer = char *;
+  using const_pointer = const char *;
+
+  static constexpr size_type npos{std::string_view::npos};
+
+  fixed_size_string();
+  fixed_size_string(const char *str);
+  fixed_size_string(const char *str, size_type count);
+  explicit fixed_size_string(std::string_view view);
+
+  static constexpr size_type capacity();
+  static constexpr size_type max_size();
+  size_type size() const;
+  size_type length() const;
+  bool empty() const;
+  bool full() const;
+
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+
+  pointer data();
+  const_pointer data() const;
+  const_pointer c_str() const;
+  std::string_view view() const;
+  operator std::string_view() const;
+
+  void push_back(char ch);
+  void pop_back();
+  fixed_size_string &append(std::string_view view);
+  fixed_size_string &operator+=(char ch);
+  fixed_size_string &operator+=(std::string_view view);
+  void clear();
+
+  size_type find(char ch, size_type pos = 0) const;
+  size_type find(std::string_view view, size_type pos = 0) const;
+  size_type rfind(char ch, size_type pos = npos) const;
+  size_type rfind(std::string_view view, size_type pos = npos) const;
+  bool starts_with(std::string_view view) const;
+  bool starts_with(char ch) const;
+  bool ends_with(std::string_view view) const;
+  bool ends_with(char ch) const;
+  int compare(std::string_view view) const;
+
+  bool equals(const fixed_size_string &other) const;
+
+  private:
+  char buffer[Capacity + 1]{};
+  void set_size(size_type new_size);
+};
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity>::fixed_size_string() {
+  set_size(0);
+}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity>::fixed_size_string(const char *str)
+    : fixed_size_string{std::string_view{str}} {}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity>::fixed_size_string(const char *str,
+                                               size_type count)
+    : fixed_size_string{std::string_view{str, count}} {}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity>::fixed_size_string(std::string_view view) {
+  if (view.size() > Capacity) throw std::bad_alloc{};
+  std::char_traits<char>::copy(buffer, view.data(), view.size());
+  set_size(view.size());
+}
+
+template <std::size_t Capacity>
+constexpr typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::capacity() {
+  return Capacity;
+}
+
+template <std::size_t Capacity>
+constexpr typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::max_size() {
+  return Capacity;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::size() const {
+  return Capacity - static_cast<unsigned char>(buffer[Capacity]);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::length() const {
+  return size();
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::empty() const {
+  return size() == 0u;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::full() const {
+  return buffer[Capacity] == 0;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::reference
+    fixed_size_string<Capacity>::operator[](const size_type pos) {
+  return buffer[pos];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_reference
+    fixed_size_string<Capacity>::operator[](const size_type pos) const {
+  return buffer[pos];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::reference
+fixed_size_string<Capacity>::at(const size_type pos) {
+  if (pos >= size()) throw std::out_of_range{""};
+  return buffer[pos];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_reference
+fixed_size_string<Capacity>::at(const size_type pos) const {
+  if (pos >= size()) throw std::out_of_range{""};
+  return buffer[pos];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::reference
+fixed_size_string<Capacity>::front() {
+  return buffer[0];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_reference
+fixed_size_string<Capacity>::front() const {
+  return buffer[0];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::reference
+fixed_size_string<Capacity>::back() {
+  return buffer[size() - 1];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_reference
+fixed_size_string<Capacity>::back() const {
+  return buffer[size() - 1];
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::iterator
+fixed_size_string<Capacity>::begin() {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_iterator
+fixed_size_string<Capacity>::begin() const {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_iterator
+fixed_size_string<Capacity>::cbegin() const {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::iterator
+fixed_size_string<Capacity>::end() {
+  return buffer + size();
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_iterator
+fixed_size_string<Capacity>::end() const {
+  return buffer + size();
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_iterator
+fixed_size_string<Capacity>::cend() const {
+  return buffer + size();
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::pointer
+fixed_size_string<Capacity>::data() {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_pointer
+fixed_size_string<Capacity>::data() const {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::const_pointer
+fixed_size_string<Capacity>::c_str() const {
+  return buffer;
+}
+
+template <std::size_t Capacity>
+std::string_view fixed_size_string<Capacity>::view() const {
+  return std::string_view{buffer, size()};
+}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity>::operator std::string_view() const {
+  return view();
+}
+
+template <std::size_t Capacity>
+void fixed_size_string<Capacity>::push_back(const char ch) {
+  if (full()) throw std::bad_alloc{};
+  const size_type current_size = size();
+  buffer[current_size] = ch;
+  set_size(current_size + 1);
+}
+
+template <std::size_t Capacity>
+void fixed_size_string<Capacity>::pop_back() {
+  const size_type current_size = size();
+  buffer[current_size - 1] = '\0';
+  set_size(current_size - 1);
+}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity> &fixed_size_string<Capacity>::append(
+    std::string_view view) {
+  const size_type current_size = size();
+  if (view.size() > Capacity - current_size) throw std::bad_alloc{};
+  std::char_traits<char>::move(buffer + current_size, view.data(),
+                               view.size());
+  set_size(current_size + view.size());
+  return *this;
+}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity> &fixed_size_string<Capacity>::operator+=(
+    const char ch) {
+  push_back(ch);
+  return *this;
+}
+
+template <std::size_t Capacity>
+fixed_size_string<Capacity> &fixed_size_string<Capacity>::operator+=(
+    std::string_view view) {
+  return append(view);
+}
+
+template <std::size_t Capacity>
+void fixed_size_string<Capacity>::clear() {
+  std::memset(buffer, 0, size());
+  set_size(0);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::find(const char ch, const size_type pos) const {
+  const size_type current_size = size();
+  if (pos >= current_size) return npos;
+  const size_type found =
+      pos + detail::find_byte(buffer + pos, current_size - pos, ch);
+  return found == current_size ? npos : found;
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::find(std::string_view view,
+                                  const size_type pos) const {
+  return this->view().find(view, pos);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::rfind(const char ch, const size_type pos) const {
+  return view().rfind(ch, pos);
+}
+
+template <std::size_t Capacity>
+typename fixed_size_string<Capacity>::size_type
+fixed_size_string<Capacity>::rfind(std::string_view view,
+                                   const size_type pos) const {
+  return this->view().rfind(view, pos);
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::starts_with(std::string_view view) const {
+  return size() >= view.size() &&
+         std::string_view{buffer, view.size()} == view;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::starts_with(const char ch) const {
+  return !empty() && buffer[0] == ch;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::ends_with(std::string_view view) const {
+  const size_type current_size = size();
+  return current_size >= view.size() &&
+         std::string_view{buffer + current_size - view.size(), view.size()} ==
+             view;
+}
+
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::ends_with(const char ch) const {
+  return !empty() && back() == ch;
+}
+
+template <std::size_t Capacity>
+int fixed_size_string<Capacity>::compare(std::string_view view) const {
+  return this->view().compare(view);
+}
+
+// Both buffers are zero past their sizes and end with the size byte, so a
+// single fixed-length comparison checks length and contents together.
+template <std::size_t Capacity>
+bool fixed_size_string<Capacity>::equals(
+    const fixed_size_string &other) const {
+  return detail::equal_bytes(buffer, other.buffer, Capacity + 1);
+}
+
+template <std::size_t Capacity>
+void fixed_size_string<Capacity>::set_size(const size_type new_size) {
+  buffer[Capacity] = static_cast<char>(Capacity - new_size);
+}
+
+template <std::size_t Capacity>
+bool operator==(const fixed_size_string<Capacity> &lhs,
+                const fixed_size_string<Capacity> &rhs) {
+  return lhs.equals(rhs);
+}
+
+template <std::size_t Capacity>
+bool operator==(const fixed_size_string<Capacity> &lhs, std::string_view rhs) {
+  return lhs.size() == rhs.size() &&
+         detail::equal_bytes(lhs.data(), rhs.data(), rhs.size());
+}
+
+template <std::size_t Capacity>
+bool operator==(std::string_view lhs, const fixed_size_string<Capacity> &rhs) {
+  return rhs == lhs;
+}
+
+template <std::size_t Capacity>
+bool operator!=(const fixed_size_string<Capacity> &lhs,
+                const fixed_size_string<Capacity> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <std::size_t Capacity>
+bool operator!=(const fixed_size_string<Capacity> &lhs, std::string_view rhs) {
+  return !(lhs == rhs);
+}
+
+template <std::size_t Capacity>
+bool operator!=(std::string_view lhs, const fixed_size_string<Capacity> &rhs) {
+  return !(rhs == lhs);
+}
+
+template <std::size_t Capacity>
+bool operator<(const fixed_size_string<Capacity> &lhs,
+               const fixed_size_string<Capacity> &rhs) {
+  return lhs.compare(rhs) < 0;
+}
+
+template <std::size_t Capacity>
+bool operator<=(const fixed_size_string<Capacity> &lhs,
+                const fixed_size_string<Capacity> &rhs) {
+  return lhs.compare(rhs) <= 0;
+}
+
+template <std::size_t Capacity>
+bool operator>(const fixed_size_string<Capacity> &lhs,
+               const fixed_size_string<Capacity> &rhs) {
+  return lhs.compare(rhs) > 0;
+}
+
+template <std::size_t Capacity>
+bool operator>=(const fixed_size_string<Capacity> &lhs,
+                const fixed_size_string<Capacity> &rhs) {
+  return lhs.compare(rhs) >= 0;
+}
+}  // namespace utils
+
+namespace std {
+template <std::size_t Capacity>
+struct hash<utils::fixed_size_string<Capacity>> {
+  std::size_t operator()(
+      const utils::fixed_size_string<Capacity> &str) const noexcept {
+    return utils::detail::hash_bytes(str.data(), str.size());
+  }
+};
+}  // namespace std
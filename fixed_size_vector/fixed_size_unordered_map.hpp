@@ -0,0 +1,520 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_size_simd.hpp"
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+namespace detail {
+constexpr std::size_t round_up_pow2(std::size_t value) {
+  std::size_t result{1};
+  while (result < value) result <<= 1;
+  return result;
+}
+
+struct key_of_pair {
+  template <typename Pair>
+  const typename Pair::first_type &operator()(const Pair &value) const {
+    return value.first;
+  }
+};
+
+struct key_of_identity {
+  template <typename Key>
+  const Key &operator()(const Key &value) const {
+    return value;
+  }
+};
+
+// Open-addressing table shared by fixed_size_unordered_map and
+// fixed_size_unordered_set. Elements are kept densely in a fixed_size_vector,
+// so iteration is a linear walk over size() elements. The table itself is a
+// power-of-two array of one-byte control words and element indices, probed
+// linearly:
+//
+//   control byte 0x80      empty slot
+//   control byte 0..127    occupied, low 7 bits of the key's hash
+//
+// A lookup compares the 16 control bytes starting at the home slot against
+// the hash fragment at once, and only touches elements whose fragment
+// matches. The first 15 control bytes are mirrored past the end so a group
+// never has to wrap. Erase shifts the rest of the probe run backward instead
+// of leaving tombstones, so lookups never degrade after churn.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+class fixed_size_hash_table {
+  static_assert(std::is_nothrow_move_assignable_v<Value>,
+                "erase moves the last element into the hole and must not "
+                "throw halfway through");
+
+  public:
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = value_type *;
+  using const_iterator = const value_type *;
+
+  fixed_size_hash_table();
+
+  static constexpr size_type capacity();
+  size_type size() const;
+  bool empty() const;
+
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+  size_type count(const key_type &key) const;
+
+  size_type erase(const key_type &key);
+  void clear();
+
+  protected:
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_key(const key_type &key, Args &&... args);
+
+  private:
+  using index_type = compact_size_t<Capacity>;
+
+  static constexpr size_type group_width{16};
+  // At most 7/8 of the slots are ever occupied, and at least one is always
+  // empty so every probe terminates.
+  static constexpr size_type slot_count{
+      round_up_pow2(Capacity + Capacity / 7 + 1)};
+  static constexpr size_type slot_mask{slot_count - 1};
+  static constexpr size_type npos{static_cast<size_type>(-1)};
+  static constexpr unsigned char empty_control{0x80};
+
+  fixed_size_vector<value_type, Capacity> entries;
+  unsigned char control[slot_count + group_width - 1];
+  index_type slot_index[slot_count];
+  Hash hash{};
+  KeyEqual equal{};
+
+  size_type hash_of(const key_type &key) const;
+  size_type find_slot(const key_type &key, size_type key_hash) const;
+  size_type find_empty_slot(size_type key_hash) const;
+  void set_control(size_type slot, unsigned char value);
+  void remove_slot(size_type slot);
+};
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::fixed_size_hash_table() {
+  std::memset(control, empty_control, sizeof(control));
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+constexpr typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity,
+                                         Hash, KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::capacity() {
+  return Capacity;
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::size() const {
+  return entries.size();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+bool fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                           KeyEqual>::empty() const {
+  return entries.empty();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::begin() {
+  return entries.begin();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::const_iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::begin() const {
+  return entries.begin();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::const_iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::cbegin() const {
+  return entries.begin();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::end() {
+  return entries.end();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::const_iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::end() const {
+  return entries.end();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::const_iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::cend() const {
+  return entries.end();
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash, KeyEqual>::find(
+    const key_type &key) {
+  const size_type slot = find_slot(key, hash_of(key));
+  return slot == npos ? end() : begin() + slot_index[slot];
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::const_iterator
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash, KeyEqual>::find(
+    const key_type &key) const {
+  const size_type slot = find_slot(key, hash_of(key));
+  return slot == npos ? end() : begin() + slot_index[slot];
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+bool fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                           KeyEqual>::contains(const key_type &key) const {
+  return find_slot(key, hash_of(key)) != npos;
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::count(const key_type &key) const {
+  return contains(key) ? 1 : 0;
+}
+
+// Erasing moves the last element into the hole, so it invalidates iterators
+// and references to the erased and to the last element.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::erase(const key_type &key) {
+  const size_type slot = find_slot(key, hash_of(key));
+  if (slot == npos) return 0;
+  const size_type pos = slot_index[slot];
+  remove_slot(slot);
+  const size_type last = entries.size() - 1;
+  if (pos != last) {
+    const key_type &moved_key = KeyOfValue{}(entries[last]);
+    slot_index[find_slot(moved_key, hash_of(moved_key))] =
+        static_cast<index_type>(pos);
+    entries[pos] = std::move(entries[last]);
+  }
+  entries.pop_back();
+  return 1;
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+void fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                           KeyEqual>::clear() {
+  entries.clear();
+  std::memset(control, empty_control, sizeof(control));
+}
+
+// Inserts a value built from args unless key is already present. Throws
+// std::bad_alloc when the table is full.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity,
+                                         Hash, KeyEqual>::iterator,
+          bool>
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::emplace_key(const key_type &key,
+                                             Args &&... args) {
+  const size_type key_hash = hash_of(key);
+  const size_type found = find_slot(key, key_hash);
+  if (found != npos) return {begin() + slot_index[found], false};
+  if (entries.size() == Capacity) throw std::bad_alloc{};
+  entries.emplace_back(std::forward<Args>(args)...);
+  const size_type slot = find_empty_slot(key_hash);
+  slot_index[slot] = static_cast<index_type>(entries.size() - 1);
+  set_control(slot, static_cast<unsigned char>(key_hash & 0x7F));
+  return {end() - 1, true};
+}
+
+// std::hash is the identity for integers on common implementations, so the
+// result is mixed before its low bits pick the fragment and home slot.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::hash_of(const key_type &key) const {
+  return static_cast<size_type>(
+      mix64(static_cast<std::uint64_t>(hash(key))));
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::find_slot(const key_type &key,
+                                           const size_type key_hash) const {
+  const auto fragment = static_cast<unsigned char>(key_hash & 0x7F);
+  size_type pos = (key_hash >> 7) & slot_mask;
+  for (size_type probed = 0; probed < slot_count; probed += group_width) {
+    std::uint32_t matches = match_byte16(control + pos, fragment);
+    while (matches != 0) {
+      const size_type slot = (pos + count_trailing_zeros(matches)) & slot_mask;
+      if (equal(KeyOfValue{}(entries[slot_index[slot]]), key)) return slot;
+      matches &= matches - 1;
+    }
+    if (match_byte16(control + pos, empty_control) != 0) return npos;
+    pos = (pos + group_width) & slot_mask;
+  }
+  return npos;
+}
+
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                               KeyEqual>::size_type
+fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                      KeyEqual>::find_empty_slot(const size_type key_hash)
+    const {
+  size_type pos = (key_hash >> 7) & slot_mask;
+  for (;;) {
+    const std::uint32_t empties = match_byte16(control + pos, empty_control);
+    if (empties != 0) {
+      return (pos + count_trailing_zeros(empties)) & slot_mask;
+    }
+    pos = (pos + group_width) & slot_mask;
+  }
+}
+
+// Keeps the mirrored tail in sync. Tables smaller than a group mirror their
+// control bytes more than once.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+void fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                           KeyEqual>::set_control(const size_type slot,
+                                                  const unsigned char value) {
+  control[slot] = value;
+  for (size_type mirror = slot + slot_count;
+       mirror < slot_count + group_width - 1; mirror += slot_count) {
+    control[mirror] = value;
+  }
+}
+
+// Backward-shift deletion: every later entry of the probe run whose home
+// slot is not between the hole and itself moves into the hole, which keeps
+// each entry reachable from its home without crossing an empty slot.
+template <typename Value, typename Key, typename KeyOfValue,
+          std::size_t Capacity, typename Hash, typename KeyEqual>
+void fixed_size_hash_table<Value, Key, KeyOfValue, Capacity, Hash,
+                           KeyEqual>::remove_slot(size_type slot) {
+  for (size_type next = (slot + 1) & slot_mask; control[next] != empty_control;
+       next = (next + 1) & slot_mask) {
+    const size_type home =
+        (hash_of(KeyOfValue{}(entries[slot_index[next]])) >> 7) & slot_mask;
+    if (((next - home) & slot_mask) < ((next - slot) & slot_mask)) continue;
+    set_control(slot, control[next]);
+    slot_index[slot] = slot_index[next];
+    slot = next;
+  }
+  set_control(slot, empty_control);
+}
+}  // namespace detail
+
+// Unordered map with inline storage for up to Capacity elements. Lookups
+// probe 16 control bytes at a time and iteration is over a dense array of
+// std::pair<Key, T>. Inserting into a full map throws std::bad_alloc.
+// Unlike std::unordered_map, the key is not const, so that erase can
+// move-assign the last element into the hole; changing a key through an
+// iterator is undefined. Erase also invalidates the last element's
+// iterator.
+template <typename Key, typename T, std::size_t Capacity,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class fixed_size_unordered_map
+    : public detail::fixed_size_hash_table<std::pair<Key, T>, Key,
+                                           detail::key_of_pair, Capacity, Hash,
+                                           KeyEqual> {
+  using base_type =
+      detail::fixed_size_hash_table<std::pair<Key, T>, Key,
+                                    detail::key_of_pair, Capacity, Hash,
+                                    KeyEqual>;
+
+  public:
+  using mapped_type = T;
+  using typename base_type::const_iterator;
+  using typename base_type::iterator;
+  using typename base_type::key_type;
+  using typename base_type::value_type;
+
+  std::pair<iterator, bool> insert(const value_type &value);
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args);
+
+  mapped_type &operator[](const key_type &key);
+  mapped_type &at(const key_type &key);
+  const mapped_type &at(const key_type &key) const;
+};
+
+template <typename Key, typename T, std::size_t Capacity, typename Hash,
+          typename KeyEqual>
+std::pair<typename fixed_size_unordered_map<Key, T, Capacity, Hash,
+                                            KeyEqual>::iterator,
+          bool>
+fixed_size_unordered_map<Key, T, Capacity, Hash, KeyEqual>::insert(
+    const value_type &value) {
+  return this->emplace_key(value.first, value);
+}
+
+template <typename Key, typename T, std::size_t Capacity, typename Hash,
+          typename KeyEqual>
+template <typename... Args>
+std::pair<typename fixed_size_unordered_map<Key, T, Capacity, Hash,
+                                            KeyEqual>::iterator,
+          bool>
+fixed_size_unordered_map<Key, T, Capacity, Hash, KeyEqual>::try_emplace(
+    const key_type &key, Args &&... args) {
+  return this->emplace_key(key, std::piecewise_construct,
+                           std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+template <typename Key, typename T, std::size_t Capacity, typename Hash,
+          typename KeyEqual>
+typename fixed_size_unordered_map<Key, T, Capacity, Hash,
+                                  KeyEqual>::mapped_type &
+fixed_size_unordered_map<Key, T, Capacity, Hash, KeyEqual>::operator[](
+    const key_type &key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename Key, typename T, std::size_t Capacity, typename Hash,
+          typename KeyEqual>
+typename fixed_size_unordered_map<Key, T, Capacity, Hash,
+                                  KeyEqual>::mapped_type &
+fixed_size_unordered_map<Key, T, Capacity, Hash, KeyEqual>::at(
+    const key_type &key) {
+  const iterator found = this->find(key);
+  if (found == this->end()) throw std::out_of_range{""};
+  return found->second;
+}
+
+template <typename Key, typename T, std::size_t Capacity, typename Hash,
+          typename KeyEqual>
+const typename fixed_size_unordered_map<Key, T, Capacity, Hash,
+                                        KeyEqual>::mapped_type &
+fixed_size_unordered_map<Key, T, Capacity, Hash, KeyEqual>::at(
+    const key_type &key) const {
+  const const_iterator found = this->find(key);
+  if (found == this->end()) throw std::out_of_range{""};
+  return found->second;
+}
+
+// Unordered set with inline storage for up to Capacity keys, built on the
+// same table as fixed_size_unordered_map. Iterators are read-only.
+template <typename Key, std::size_t Capacity, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class fixed_size_unordered_set
+    : public detail::fixed_size_hash_table<Key, Key, detail::key_of_identity,
+                                           Capacity, Hash, KeyEqual> {
+  using base_type =
+      detail::fixed_size_hash_table<Key, Key, detail::key_of_identity,
+                                    Capacity, Hash, KeyEqual>;
+
+  public:
+  using typename base_type::const_iterator;
+  using typename base_type::key_type;
+  using iterator = const_iterator;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator find(const key_type &key) const;
+
+  std::pair<const_iterator, bool> insert(const key_type &key);
+};
+
+template <typename Key, std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_unordered_set<Key, Capacity, Hash,
+                                  KeyEqual>::const_iterator
+fixed_size_unordered_set<Key, Capacity, Hash, KeyEqual>::begin() const {
+  return base_type::begin();
+}
+
+template <typename Key, std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_unordered_set<Key, Capacity, Hash,
+                                  KeyEqual>::const_iterator
+fixed_size_unordered_set<Key, Capacity, Hash, KeyEqual>::end() const {
+  return base_type::end();
+}
+
+template <typename Key, std::size_t Capacity, typename Hash, typename KeyEqual>
+typename fixed_size_unordered_set<Key, Capacity, Hash,
+                                  KeyEqual>::const_iterator
+fixed_size_unordered_set<Key, Capacity, Hash, KeyEqual>::find(
+    const key_type &key) const {
+  return base_type::find(key);
+}
+
+template <typename Key, std::size_t Capacity, typename Hash, typename KeyEqual>
+std::pair<typename fixed_size_unordered_set<Key, Capacity, Hash,
+                                            KeyEqual>::const_iterator,
+          bool>
+fixed_size_unordered_set<Key, Capacity, Hash, KeyEqual>::insert(
+    const key_type &key) {
+  return this->emplace_key(key, key);
+}
+}  // namespace utils
@@ -1,8 +1,48 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
+
+#include "fixed_size_simd.hpp"
+
+// Copies of trivially copyable contents at least this large use
+// non-temporal stores instead of going through the cache. The default is a
+// guess at "larger than a typical L2" and has not been measured; tune it
+// for the target machine. Vectors whose whole storage is smaller never
+// compile the streaming path.
+#ifndef FIXED_SIZE_VECTOR_STREAMING_THRESHOLD
+#define FIXED_SIZE_VECTOR_STREAMING_THRESHOLD (std::size_t{1} << 20)
+#endif
+
+// A moved-to vector is usually read right away, so moves go through the
+// cache unless this is set to 1.
+#ifndef FIXED_SIZE_VECTOR_STREAM_MOVES
+#define FIXED_SIZE_VECTOR_STREAM_MOVES 0
+#endif
 
 namespace utils {
+namespace detail {
+// Smallest unsigned type able to hold every size in [0, Capacity].
+template <std::size_t Capacity>
+using compact_size_t = std::conditional_t<
+    Capacity <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+    std::conditional_t<
+        Capacity <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+        std::conditional_t<
+            Capacity <= std::numeric_limits<std::uint32_t>::max(),
+            std::uint32_t, std::size_t>>>;
+}  // namespace detail
+
 template <typename T, std::size_t Capacity>
 class fixed_size_vector {
   public:
@@ -61,6 +101,17 @@ class fixed_size_vector {
   iterator erase(iterator pos);
   void pop_back();
 
+  void swap(fixed_size_vector &other) noexcept(
+      std::is_nothrow_move_constructible_v<value_type> &&
+      std::is_nothrow_swappable_v<value_type>);
+
+  void copy_streaming(const fixed_size_vector &other);
+  void fill_streaming(size_type count, const value_type &value);
+  template <typename Fn>
+  void for_each_prefetched(Fn &&fn, size_type distance = 8);
+  template <typename Fn>
+  void for_each_prefetched(Fn &&fn, size_type distance = 8) const;
+
   private:
   static constexpr size_type capacity_size{Capacity};
   using storage_type = typename std::aligned_storage<sizeof(value_type),
@@ -71,6 +122,8 @@ class fixed_size_vector {
   static U cast_pointer(storage_type *p);
   iterator get_storage();
   const_iterator get_storage() const;
+  void swap_bytes(fixed_size_vector &other) noexcept;
+  void copy_bytes(const fixed_size_vector &other, bool may_stream) noexcept;
 };
 
 template <typename T, std::size_t Capacity>
@@ -81,35 +134,61 @@ fixed_size_vector<T, Capacity>::fixed_size_vector(
   }
 }
 
+// A pointer range over trivially copyable elements is copied in one block.
 template <typename T, std::size_t Capacity>
 template <typename InputIt>
 fixed_size_vector<T, Capacity>::fixed_size_vector(InputIt first, InputIt last) {
-  for (InputIt iter = first; iter != last; ++iter) {
-    emplace_back(*iter);
+  if constexpr (std::is_pointer_v<InputIt> &&
+                std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>,
+                               value_type> &&
+                std::is_trivially_copyable_v<value_type>) {
+    const auto count = static_cast<size_type>(last - first);
+    if (count > capacity_size) throw std::bad_alloc{};
+    if (count != 0) std::memcpy(storage, first, count * sizeof(value_type));
+    current_size = count;
+  } else {
+    for (InputIt iter = first; iter != last; ++iter) {
+      if (current_size == capacity_size) throw std::bad_alloc{};
+      emplace_back(*iter);
+    }
   }
 }
 
 template <typename T, std::size_t Capacity>
 fixed_size_vector<T, Capacity>::fixed_size_vector(
     const fixed_size_vector &other) {
-  for (const auto &item : other) {
-    emplace_back(item);
+  if constexpr (std::is_trivially_copyable_v<value_type>) {
+    copy_bytes(other, true);
+  } else {
+    for (const auto &item : other) {
+      emplace_back(item);
+    }
   }
 }
 
 template <typename T, std::size_t Capacity>
 fixed_size_vector<T, Capacity>::fixed_size_vector(
     fixed_size_vector &&other) noexcept {
-  for (auto &item : other) {
-    emplace_back(std::move(item));
+  if constexpr (std::is_trivially_copyable_v<value_type>) {
+    copy_bytes(other, FIXED_SIZE_VECTOR_STREAM_MOVES != 0);
+  } else {
+    for (auto &item : other) {
+      emplace_back(std::move(item));
+    }
   }
 }
 
 template <typename T, std::size_t Capacity>
 fixed_size_vector<T, Capacity> &fixed_size_vector<T, Capacity>::operator=(
     const fixed_size_vector &other) {
-  for (const auto &item : other) {
-    emplace_back(item);
+  if (this == &other) return *this;
+  clear();
+  if constexpr (std::is_trivially_copyable_v<value_type>) {
+    copy_bytes(other, true);
+  } else {
+    for (const auto &item : other) {
+      emplace_back(item);
+    }
   }
   return *this;
 }
@@ -117,8 +196,14 @@ fixed_size_vector<T, Capacity> &fixed_size_vector<T, Capacity>::operator=(
 template <typename T, std::size_t Capacity>
 fixed_size_vector<T, Capacity> &fixed_size_vector<T, Capacity>::operator=(
     fixed_size_vector &&other) noexcept {
-  for (auto &item : other) {
-    emplace_back(std::move(item));
+  if (this == &other) return *this;
+  clear();
+  if constexpr (std::is_trivially_copyable_v<value_type>) {
+    copy_bytes(other, FIXED_SIZE_VECTOR_STREAM_MOVES != 0);
+  } else {
+    for (auto &item : other) {
+      emplace_back(std::move(item));
+    }
   }
   return *this;
 }
@@ -285,6 +370,7 @@ void fixed_size_vector<T, Capacity>::clear() {
   for (value_type &item : *this) {
     item.~value_type();
   }
+  current_size = 0;
 }
 
 template <typename T, std::size_t Capacity>
@@ -301,7 +387,140 @@ fixed_size_vector<T, Capacity>::erase(iterator pos) {
 
 template <typename T, std::size_t Capacity>
 void fixed_size_vector<T, Capacity>::pop_back() {
-  erase(end() - 1);
+  back().~value_type();
+  --current_size;
+}
+
+template <typename T, std::size_t Capacity>
+void fixed_size_vector<T, Capacity>::swap(fixed_size_vector &other) noexcept(
+    std::is_nothrow_move_constructible_v<value_type> &&
+    std::is_nothrow_swappable_v<value_type>) {
+  if (this == &other) return;
+  if constexpr (std::is_trivially_copyable_v<value_type>) {
+    swap_bytes(other);
+  } else {
+    fixed_size_vector &shorter =
+        current_size < other.current_size ? *this : other;
+    fixed_size_vector &longer =
+        current_size < other.current_size ? other : *this;
+    using std::swap;
+    for (size_type i = 0; i < shorter.current_size; ++i) {
+      swap(shorter[i], longer[i]);
+    }
+    for (size_type i = shorter.current_size; i < longer.current_size; ++i) {
+      new (shorter.storage + i) value_type{std::move(longer[i])};
+      longer[i].~value_type();
+    }
+  }
+  std::swap(current_size, other.current_size);
+}
+
+// Uses non-temporal stores regardless of FIXED_SIZE_VECTOR_STREAMING_THRESHOLD;
+// meant for snapshots the caller will not read back right away. Contents
+// too small to stream (a few cache lines) still go through memcpy.
+template <typename T, std::size_t Capacity>
+void fixed_size_vector<T, Capacity>::copy_streaming(
+    const fixed_size_vector &other) {
+  static_assert(std::is_trivially_copyable_v<value_type>,
+                "copy_streaming requires a trivially copyable type");
+  if (this == &other) return;
+  detail::stream_copy(storage, other.storage,
+                      other.current_size * sizeof(value_type));
+  current_size = other.current_size;
+}
+
+// Replaces the contents with count copies of value. The first block is
+// written normally and then streamed into the rest of the buffer.
+template <typename T, std::size_t Capacity>
+void fixed_size_vector<T, Capacity>::fill_streaming(const size_type count,
+                                                    const value_type &value) {
+  static_assert(std::is_trivially_copyable_v<value_type>,
+                "fill_streaming requires a trivially copyable type");
+  if (count > capacity_size) throw std::bad_alloc{};
+  constexpr size_type block_size{
+      sizeof(value_type) >= 4096 ? 1 : 4096 / sizeof(value_type)};
+  const size_type first_block = std::min(count, block_size);
+  std::fill_n(get_storage(), first_block, value);
+  for (size_type pos = first_block; pos < count; pos += block_size) {
+    detail::stream_copy(storage + pos, storage,
+                        std::min(block_size, count - pos) * sizeof(value_type));
+  }
+  current_size = count;
+}
+
+// Visits every element, prefetching the cache line distance elements ahead.
+template <typename T, std::size_t Capacity>
+template <typename Fn>
+void fixed_size_vector<T, Capacity>::for_each_prefetched(
+    Fn &&fn, const size_type distance) {
+  constexpr size_type per_line{
+      sizeof(value_type) >= 64 ? 1 : 64 / sizeof(value_type)};
+  iterator first = get_storage();
+  for (size_type pos = 0; pos < current_size; ++pos) {
+    if (pos % per_line == 0 && pos + distance < current_size) {
+      detail::prefetch_read(first + pos + distance);
+    }
+    fn(first[pos]);
+  }
+}
+
+template <typename T, std::size_t Capacity>
+template <typename Fn>
+void fixed_size_vector<T, Capacity>::for_each_prefetched(
+    Fn &&fn, const size_type distance) const {
+  constexpr size_type per_line{
+      sizeof(value_type) >= 64 ? 1 : 64 / sizeof(value_type)};
+  const_iterator first = get_storage();
+  for (size_type pos = 0; pos < current_size; ++pos) {
+    if (pos % per_line == 0 && pos + distance < current_size) {
+      detail::prefetch_read(first + pos + distance);
+    }
+    fn(first[pos]);
+  }
+}
+
+// Copies the used prefix in one pass. When may_stream is set, contents of
+// at least FIXED_SIZE_VECTOR_STREAMING_THRESHOLD bytes bypass the cache.
+template <typename T, std::size_t Capacity>
+void fixed_size_vector<T, Capacity>::copy_bytes(
+    const fixed_size_vector &other, const bool may_stream) noexcept {
+  const size_type bytes = other.current_size * sizeof(value_type);
+  if constexpr (Capacity * sizeof(value_type) >=
+                FIXED_SIZE_VECTOR_STREAMING_THRESHOLD) {
+    if (may_stream && bytes >= FIXED_SIZE_VECTOR_STREAMING_THRESHOLD) {
+      detail::stream_copy(storage, other.storage, bytes);
+      current_size = other.current_size;
+      return;
+    }
+  }
+  if (bytes != 0) std::memcpy(storage, other.storage, bytes);
+  current_size = other.current_size;
+}
+
+// Swaps only the used prefix through a small stack buffer, then copies the
+// tail of the longer vector; sizes are exchanged by the caller.
+template <typename T, std::size_t Capacity>
+void fixed_size_vector<T, Capacity>::swap_bytes(
+    fixed_size_vector &other) noexcept {
+  constexpr size_type chunk_size{256};
+  unsigned char buffer[chunk_size];
+  auto *lhs = reinterpret_cast<unsigned char *>(storage);
+  auto *rhs = reinterpret_cast<unsigned char *>(other.storage);
+  const size_type common =
+      std::min(current_size, other.current_size) * sizeof(value_type);
+  for (size_type offset = 0; offset < common; offset += chunk_size) {
+    const size_type count = std::min(chunk_size, common - offset);
+    std::memcpy(buffer, lhs + offset, count);
+    std::memcpy(lhs + offset, rhs + offset, count);
+    std::memcpy(rhs + offset, buffer, count);
+  }
+  if (current_size < other.current_size) {
+    std::memcpy(lhs + common, rhs + common,
+                other.current_size * sizeof(value_type) - common);
+  } else {
+    std::memcpy(rhs + common, lhs + common,
+                current_size * sizeof(value_type) - common);
+  }
 }
 
 template <typename T, std::size_t Capacity>
@@ -333,4 +552,116 @@ constexpr typename fixed_size_vector<T, Capacity>::size_type
 fixed_size_vector<T, Capacity>::max_size() {
   return capacity_size;
 }
+
+template <typename T, std::size_t Capacity>
+void swap(fixed_size_vector<T, Capacity> &lhs,
+          fixed_size_vector<T, Capacity> &rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+namespace detail {
+// Types whose equality is exactly equality of their bytes.
+template <typename T>
+constexpr bool is_bytewise_equal_comparable_v =
+    std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+// Types whose ordering is exactly memcmp's unsigned byte ordering.
+template <typename T>
+constexpr bool is_bytewise_less_comparable_v =
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte> ||
+    (std::is_same_v<T, char> && std::is_unsigned_v<char>);
+
+template <typename T, std::size_t Capacity>
+int compare_bytes(const fixed_size_vector<T, Capacity> &lhs,
+                  const fixed_size_vector<T, Capacity> &rhs) {
+  const std::size_t common = std::min(lhs.size(), rhs.size());
+  const int result =
+      common == 0 ? 0 : std::memcmp(lhs.data(), rhs.data(), common);
+  if (result != 0) return result;
+  return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+}
+}  // namespace detail
+
+template <typename T, std::size_t Capacity>
+bool operator==(const fixed_size_vector<T, Capacity> &lhs,
+                const fixed_size_vector<T, Capacity> &rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  if constexpr (detail::is_bytewise_equal_comparable_v<T>) {
+    return detail::equal_bytes(lhs.data(), rhs.data(), lhs.size() * sizeof(T));
+  } else {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+}
+
+template <typename T, std::size_t Capacity>
+bool operator!=(const fixed_size_vector<T, Capacity> &lhs,
+                const fixed_size_vector<T, Capacity> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, std::size_t Capacity>
+bool operator<(const fixed_size_vector<T, Capacity> &lhs,
+               const fixed_size_vector<T, Capacity> &rhs) {
+  if constexpr (detail::is_bytewise_less_comparable_v<T>) {
+    return detail::compare_bytes(lhs, rhs) < 0;
+  } else {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+  }
+}
+
+template <typename T, std::size_t Capacity>
+bool operator>(const fixed_size_vector<T, Capacity> &lhs,
+               const fixed_size_vector<T, Capacity> &rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, std::size_t Capacity>
+bool operator<=(const fixed_size_vector<T, Capacity> &lhs,
+                const fixed_size_vector<T, Capacity> &rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, std::size_t Capacity>
+bool operator>=(const fixed_size_vector<T, Capacity> &lhs,
+                const fixed_size_vector<T, Capacity> &rhs) {
+  return !(lhs < rhs);
+}
+
+#if defined(__cpp_lib_three_way_comparison)
+template <typename T, std::size_t Capacity>
+auto operator<=>(const fixed_size_vector<T, Capacity> &lhs,
+                 const fixed_size_vector<T, Capacity> &rhs) {
+  if constexpr (detail::is_bytewise_less_comparable_v<T>) {
+    return detail::compare_bytes(lhs, rhs) <=> 0;
+  } else {
+    return std::lexicographical_compare_three_way(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+        std::compare_three_way{});
+  }
+}
+#endif
 }  // namespace utils
+
+// Types that operator== compares bytewise are hashed as one block of bytes;
+// anything else combines the element hashes, so a user-defined operator==
+// that ignores some members still agrees with the hash.
+namespace std {
+template <typename T, std::size_t Capacity>
+struct hash<utils::fixed_size_vector<T, Capacity>> {
+  std::size_t operator()(
+      const utils::fixed_size_vector<T, Capacity> &values) const {
+    if constexpr (utils::detail::is_bytewise_equal_comparable_v<T>) {
+      return utils::detail::hash_bytes(values.data(),
+                                       values.size() * sizeof(T));
+    } else {
+      std::size_t seed{values.size()};
+      for (const T &item : values) {
+        seed ^= std::hash<T>{}(item) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+      return seed;
+    }
+  }
+};
+}  // namespace std
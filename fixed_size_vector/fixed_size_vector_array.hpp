@@ -0,0 +1,528 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "fixed_size_simd.hpp"
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+// Allocates whole 2 MiB blocks. On Linux the block is mmap'ed and marked for
+// transparent huge pages; elsewhere it falls back to 2 MiB aligned operator
+// new, which still keeps a large table from straddling extra pages.
+template <typename T>
+class huge_page_allocator {
+  public:
+  using value_type = T;
+  static constexpr std::size_t huge_page_size{std::size_t{2} << 20};
+
+  huge_page_allocator() = default;
+  template <typename U>
+  huge_page_allocator(const huge_page_allocator<U> &) noexcept {}
+
+  T *allocate(std::size_t count);
+  void deallocate(T *p, std::size_t count) noexcept;
+
+  private:
+  static std::size_t rounded_bytes(std::size_t count);
+};
+
+template <typename T>
+T *huge_page_allocator<T>::allocate(std::size_t count) {
+  const std::size_t bytes = rounded_bytes(count);
+#if defined(__linux__)
+  void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) throw std::bad_alloc{};
+#if defined(MADV_HUGEPAGE)
+  madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+  return static_cast<T *>(p);
+#else
+  return static_cast<T *>(
+      ::operator new(bytes, std::align_val_t{huge_page_size}));
+#endif
+}
+
+template <typename T>
+void huge_page_allocator<T>::deallocate(T *p, std::size_t count) noexcept {
+#if defined(__linux__)
+  munmap(p, rounded_bytes(count));
+#else
+  ::operator delete(p, rounded_bytes(count), std::align_val_t{huge_page_size});
+#endif
+}
+
+template <typename T>
+std::size_t huge_page_allocator<T>::rounded_bytes(std::size_t count) {
+  const std::size_t bytes = count * sizeof(T);
+  return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+template <typename T, typename U>
+bool operator==(const huge_page_allocator<T> &,
+                const huge_page_allocator<U> &) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const huge_page_allocator<T> &,
+                const huge_page_allocator<U> &) {
+  return false;
+}
+
+// Non-owning view of one slot of a fixed_size_vector_array with the
+// fixed_size_vector interface. T is const-qualified for read-only slots.
+template <typename T, std::size_t Capacity>
+class fixed_size_vector_slot {
+  using stored_size_type =
+      std::conditional_t<std::is_const_v<T>,
+                         const detail::compact_size_t<Capacity>,
+                         detail::compact_size_t<Capacity>>;
+
+  public:
+  using value_type = std::remove_const_t<T>;
+  using size_type = std::size_t;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+
+  fixed_size_vector_slot(T *elements, stored_size_type *size);
+
+  static constexpr size_type capacity();
+  static constexpr size_type max_size();
+  size_type size() const;
+  bool empty() const;
+  bool full() const;
+
+  void push_back(const value_type &val) const;
+  void push_back(value_type &&val) const;
+  template <typename... Args>
+  void emplace_back(Args &&... args) const;
+  void pop_back() const;
+  iterator erase(iterator pos) const;
+  void clear() const;
+
+  reference operator[](size_type pos) const;
+  reference at(size_type pos) const;
+  reference front() const;
+  reference back() const;
+  iterator begin() const;
+  iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+  pointer data() const;
+
+  private:
+  T *elements;
+  stored_size_type *current_size;
+};
+
+template <typename T, std::size_t Capacity>
+fixed_size_vector_slot<T, Capacity>::fixed_size_vector_slot(
+    T *elements, stored_size_type *size)
+    : elements{elements}, current_size{size} {}
+
+template <typename T, std::size_t Capacity>
+constexpr typename fixed_size_vector_slot<T, Capacity>::size_type
+fixed_size_vector_slot<T, Capacity>::capacity() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity>
+constexpr typename fixed_size_vector_slot<T, Capacity>::size_type
+fixed_size_vector_slot<T, Capacity>::max_size() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::size_type
+fixed_size_vector_slot<T, Capacity>::size() const {
+  return *current_size;
+}
+
+template <typename T, std::size_t Capacity>
+bool fixed_size_vector_slot<T, Capacity>::empty() const {
+  return *current_size == 0u;
+}
+
+template <typename T, std::size_t Capacity>
+bool fixed_size_vector_slot<T, Capacity>::full() const {
+  return *current_size == Capacity;
+}
+
+template <typename T, std::size_t Capacity>
+void fixed_size_vector_slot<T, Capacity>::push_back(
+    const value_type &val) const {
+  emplace_back(val);
+}
+
+template <typename T, std::size_t Capacity>
+void fixed_size_vector_slot<T, Capacity>::push_back(value_type &&val) const {
+  emplace_back(std::move(val));
+}
+
+template <typename T, std::size_t Capacity>
+template <typename... Args>
+void fixed_size_vector_slot<T, Capacity>::emplace_back(Args &&... args) const {
+  if (full()) throw std::bad_alloc{};
+  new (elements + *current_size) value_type{std::forward<Args>(args)...};
+  ++*current_size;
+}
+
+template <typename T, std::size_t Capacity>
+void fixed_size_vector_slot<T, Capacity>::pop_back() const {
+  --*current_size;
+  elements[*current_size].~value_type();
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::iterator
+fixed_size_vector_slot<T, Capacity>::erase(iterator pos) const {
+  for (auto iter = pos; iter + 1 != end(); ++iter) {
+    *iter = std::move(*(iter + 1));
+  }
+  pop_back();
+  return pos;
+}
+
+template <typename T, std::size_t Capacity>
+void fixed_size_vector_slot<T, Capacity>::clear() const {
+  for (value_type &item : *this) {
+    item.~value_type();
+  }
+  *current_size = 0;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::reference
+    fixed_size_vector_slot<T, Capacity>::operator[](
+        const size_type pos) const {
+  return elements[pos];
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::reference
+fixed_size_vector_slot<T, Capacity>::at(const size_type pos) const {
+  if (pos >= size()) throw std::out_of_range{""};
+  return elements[pos];
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::reference
+fixed_size_vector_slot<T, Capacity>::front() const {
+  return elements[0];
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::reference
+fixed_size_vector_slot<T, Capacity>::back() const {
+  return elements[*current_size - 1];
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::iterator
+fixed_size_vector_slot<T, Capacity>::begin() const {
+  return elements;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::iterator
+fixed_size_vector_slot<T, Capacity>::end() const {
+  return elements + *current_size;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::const_iterator
+fixed_size_vector_slot<T, Capacity>::cbegin() const {
+  return elements;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::const_iterator
+fixed_size_vector_slot<T, Capacity>::cend() const {
+  return elements + *current_size;
+}
+
+template <typename T, std::size_t Capacity>
+typename fixed_size_vector_slot<T, Capacity>::pointer
+fixed_size_vector_slot<T, Capacity>::data() const {
+  return elements;
+}
+
+// slot_count fixed-capacity vectors in one contiguous element block, with
+// their sizes packed into a separate array of the narrowest integer type.
+// Batch operations walk only the size array, which for byte-sized counts
+// covers sixteen slots per SSE2 compare.
+template <typename T, std::size_t Capacity,
+          typename Allocator = std::allocator<T>>
+class fixed_size_vector_array {
+  public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using slot_size_type = detail::compact_size_t<Capacity>;
+  using allocator_type = Allocator;
+  using reference = fixed_size_vector_slot<T, Capacity>;
+  using const_reference = fixed_size_vector_slot<const T, Capacity>;
+
+  explicit fixed_size_vector_array(size_type slot_count,
+                                   const Allocator &allocator = Allocator{});
+  fixed_size_vector_array(const fixed_size_vector_array &) = delete;
+  fixed_size_vector_array(fixed_size_vector_array &&other) noexcept;
+  fixed_size_vector_array &operator=(const fixed_size_vector_array &) = delete;
+  fixed_size_vector_array &operator=(fixed_size_vector_array &&other) noexcept(
+      std::allocator_traits<Allocator>::propagate_on_container_move_assignment::
+          value ||
+      std::allocator_traits<Allocator>::is_always_equal::value);
+  ~fixed_size_vector_array();
+
+  static constexpr size_type slot_capacity();
+  size_type size() const;
+  bool empty() const;
+
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+
+  const slot_size_type *sizes() const;
+  size_type total_size() const;
+  void clear_all();
+  template <typename Fn>
+  void for_each_nonempty(Fn &&fn);
+  template <typename Fn>
+  void for_each_nonempty(Fn &&fn) const;
+
+  private:
+  using storage_type = typename std::aligned_storage<sizeof(value_type),
+                                                     alignof(value_type)>::type;
+  using storage_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<storage_type>;
+  using size_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<slot_size_type>;
+
+  storage_allocator elements_allocator;
+  size_allocator sizes_allocator;
+  storage_type *storage{nullptr};
+  slot_size_type *slot_sizes{nullptr};
+  size_type slot_count{0};
+
+  T *slot_data(size_type pos) const;
+  void release();
+  void steal(fixed_size_vector_array &other) noexcept;
+  template <typename Fn>
+  void scan_nonempty(Fn &&fn) const;
+};
+
+template <typename T, std::size_t Capacity, typename Allocator>
+fixed_size_vector_array<T, Capacity, Allocator>::fixed_size_vector_array(
+    size_type slot_count, const Allocator &allocator)
+    : elements_allocator{allocator},
+      sizes_allocator{allocator},
+      slot_count{slot_count} {
+  if (slot_count == 0) return;
+  storage = elements_allocator.allocate(slot_count * Capacity);
+  try {
+    slot_sizes = sizes_allocator.allocate(slot_count);
+  } catch (...) {
+    elements_allocator.deallocate(storage, slot_count * Capacity);
+    throw;
+  }
+  std::memset(slot_sizes, 0, slot_count * sizeof(slot_size_type));
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+fixed_size_vector_array<T, Capacity, Allocator>::fixed_size_vector_array(
+    fixed_size_vector_array &&other) noexcept
+    : elements_allocator{other.elements_allocator},
+      sizes_allocator{other.sizes_allocator},
+      storage{std::exchange(other.storage, nullptr)},
+      slot_sizes{std::exchange(other.slot_sizes, nullptr)},
+      slot_count{std::exchange(other.slot_count, 0)} {}
+
+// Takes other's block when the allocator propagates or compares equal.
+// Otherwise memory from one allocator must not be freed through the other,
+// so the elements are moved one by one into a block from this allocator.
+template <typename T, std::size_t Capacity, typename Allocator>
+fixed_size_vector_array<T, Capacity, Allocator>
+    &fixed_size_vector_array<T, Capacity, Allocator>::operator=(
+        fixed_size_vector_array &&other) noexcept(
+        std::allocator_traits<Allocator>::
+            propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value) {
+  if (this == &other) return *this;
+  using traits = std::allocator_traits<Allocator>;
+  if constexpr (traits::propagate_on_container_move_assignment::value) {
+    release();
+    elements_allocator = std::move(other.elements_allocator);
+    sizes_allocator = std::move(other.sizes_allocator);
+    steal(other);
+  } else {
+    if (traits::is_always_equal::value ||
+        elements_allocator == other.elements_allocator) {
+      release();
+      steal(other);
+      return *this;
+    }
+    fixed_size_vector_array moved{other.slot_count,
+                                  Allocator(elements_allocator)};
+    other.scan_nonempty([&moved, &other](const size_type pos) {
+      T *source = other.slot_data(pos);
+      T *target = moved.slot_data(pos);
+      for (size_type i = 0; i < other.slot_sizes[pos]; ++i) {
+        new (target + i) value_type(std::move(source[i]));
+        ++moved.slot_sizes[pos];
+      }
+    });
+    release();
+    steal(moved);
+  }
+  return *this;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+fixed_size_vector_array<T, Capacity, Allocator>::~fixed_size_vector_array() {
+  release();
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+constexpr typename fixed_size_vector_array<T, Capacity, Allocator>::size_type
+fixed_size_vector_array<T, Capacity, Allocator>::slot_capacity() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::size_type
+fixed_size_vector_array<T, Capacity, Allocator>::size() const {
+  return slot_count;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+bool fixed_size_vector_array<T, Capacity, Allocator>::empty() const {
+  return slot_count == 0u;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::reference
+    fixed_size_vector_array<T, Capacity, Allocator>::operator[](
+        const size_type pos) {
+  return reference{slot_data(pos), slot_sizes + pos};
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::const_reference
+    fixed_size_vector_array<T, Capacity, Allocator>::operator[](
+        const size_type pos) const {
+  return const_reference{slot_data(pos), slot_sizes + pos};
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::reference
+fixed_size_vector_array<T, Capacity, Allocator>::at(const size_type pos) {
+  if (pos >= slot_count) throw std::out_of_range{""};
+  return (*this)[pos];
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::const_reference
+fixed_size_vector_array<T, Capacity, Allocator>::at(
+    const size_type pos) const {
+  if (pos >= slot_count) throw std::out_of_range{""};
+  return (*this)[pos];
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+const typename fixed_size_vector_array<T, Capacity, Allocator>::slot_size_type
+    *fixed_size_vector_array<T, Capacity, Allocator>::sizes() const {
+  return slot_sizes;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+typename fixed_size_vector_array<T, Capacity, Allocator>::size_type
+fixed_size_vector_array<T, Capacity, Allocator>::total_size() const {
+  size_type total{0};
+  for (size_type pos = 0; pos < slot_count; ++pos) {
+    total += slot_sizes[pos];
+  }
+  return total;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+void fixed_size_vector_array<T, Capacity, Allocator>::clear_all() {
+  if constexpr (!std::is_trivially_destructible_v<value_type>) {
+    scan_nonempty([this](size_type pos) { (*this)[pos].clear(); });
+  }
+  if (slot_count != 0) {
+    std::memset(slot_sizes, 0, slot_count * sizeof(slot_size_type));
+  }
+}
+
+// Calls fn(index, slot) for every slot holding at least one element.
+template <typename T, std::size_t Capacity, typename Allocator>
+template <typename Fn>
+void fixed_size_vector_array<T, Capacity, Allocator>::for_each_nonempty(
+    Fn &&fn) {
+  scan_nonempty([this, &fn](size_type pos) { fn(pos, (*this)[pos]); });
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+template <typename Fn>
+void fixed_size_vector_array<T, Capacity, Allocator>::for_each_nonempty(
+    Fn &&fn) const {
+  scan_nonempty([this, &fn](size_type pos) { fn(pos, (*this)[pos]); });
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+T *fixed_size_vector_array<T, Capacity, Allocator>::slot_data(
+    const size_type pos) const {
+  return reinterpret_cast<T *>(storage + pos * Capacity);
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+void fixed_size_vector_array<T, Capacity, Allocator>::release() {
+  if (storage == nullptr) return;
+  clear_all();
+  elements_allocator.deallocate(storage, slot_count * Capacity);
+  sizes_allocator.deallocate(slot_sizes, slot_count);
+  storage = nullptr;
+  slot_sizes = nullptr;
+  slot_count = 0;
+}
+
+template <typename T, std::size_t Capacity, typename Allocator>
+void fixed_size_vector_array<T, Capacity, Allocator>::steal(
+    fixed_size_vector_array &other) noexcept {
+  storage = std::exchange(other.storage, nullptr);
+  slot_sizes = std::exchange(other.slot_sizes, nullptr);
+  slot_count = std::exchange(other.slot_count, 0);
+}
+
+// Skips runs of empty slots by searching the size array for non-zero bytes;
+// the byte offset found identifies the slot it belongs to.
+template <typename T, std::size_t Capacity, typename Allocator>
+template <typename Fn>
+void fixed_size_vector_array<T, Capacity, Allocator>::scan_nonempty(
+    Fn &&fn) const {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(slot_sizes);
+  const size_type byte_count = slot_count * sizeof(slot_size_type);
+  size_type offset{0};
+  while (offset < byte_count) {
+    offset += detail::find_nonzero_byte(bytes + offset, byte_count - offset);
+    if (offset == byte_count) break;
+    const size_type pos = offset / sizeof(slot_size_type);
+    fn(pos);
+    offset = (pos + 1) * sizeof(slot_size_type);
+  }
+}
+}  // namespace utils
@@ -0,0 +1,107 @@
+#pragma once
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if defined(__cpp_lib_ranges)
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_size_vector.hpp"
+
+// fixed_size_vector exposes pointer iterators, data() and size(), so it
+// already models std::ranges::contiguous_range and sized_range. This header
+// adds to_fixed, which materializes a range or pipeline into inline storage:
+//
+//   auto ids = items | std::views::filter(pred) | utils::to_fixed<64>();
+namespace utils {
+static_assert(std::ranges::contiguous_range<fixed_size_vector<int, 1>>);
+static_assert(std::ranges::sized_range<fixed_size_vector<int, 1>>);
+
+// What to_fixed does when the source has more elements than Capacity.
+enum class overflow_policy {
+  truncate,  // keep the first Capacity elements
+  fail,      // throw std::bad_alloc
+  report     // keep the first Capacity elements and flag the result
+};
+
+template <typename T, std::size_t Capacity>
+struct to_fixed_result {
+  fixed_size_vector<T, Capacity> values;
+  bool truncated;
+};
+
+namespace detail {
+template <std::size_t Capacity, overflow_policy Policy>
+struct to_fixed_closure {
+  template <std::ranges::input_range R>
+  auto operator()(R &&range) const;
+
+  template <std::ranges::input_range R>
+  friend auto operator|(R &&range, const to_fixed_closure &closure) {
+    return closure(std::forward<R>(range));
+  }
+};
+
+// Contiguous sized sources of the element type are handed to the
+// fixed_size_vector pointer-range constructor, which copies trivially
+// copyable elements as one block; anything else is appended one by one.
+template <std::size_t Capacity, overflow_policy Policy>
+template <std::ranges::input_range R>
+auto to_fixed_closure<Capacity, Policy>::operator()(R &&range) const {
+  using value_type = std::ranges::range_value_t<R>;
+  using result_type = fixed_size_vector<value_type, Capacity>;
+  bool truncated{false};
+  result_type values = [&]() {
+    if constexpr (std::ranges::contiguous_range<R> &&
+                  std::ranges::sized_range<R> &&
+                  std::is_same_v<std::remove_cv_t<std::remove_reference_t<
+                                     std::ranges::range_reference_t<R>>>,
+                                 value_type>) {
+      auto count = static_cast<std::size_t>(std::ranges::size(range));
+      if (count > Capacity) {
+        if constexpr (Policy == overflow_policy::fail) throw std::bad_alloc{};
+        truncated = true;
+        count = Capacity;
+      }
+      const auto *first = std::ranges::data(range);
+      return result_type(first, first + count);
+    } else {
+      result_type out;
+      for (auto &&item : range) {
+        if (out.size() == Capacity) {
+          if constexpr (Policy == overflow_policy::fail) {
+            throw std::bad_alloc{};
+          }
+          truncated = true;
+          break;
+        }
+        out.emplace_back(std::forward<decltype(item)>(item));
+      }
+      return out;
+    }
+  }();
+  if constexpr (Policy == overflow_policy::report) {
+    return to_fixed_result<value_type, Capacity>{std::move(values), truncated};
+  } else {
+    return values;
+  }
+}
+}  // namespace detail
+
+template <std::size_t Capacity,
+          overflow_policy Policy = overflow_policy::fail>
+constexpr detail::to_fixed_closure<Capacity, Policy> to_fixed() {
+  return {};
+}
+
+template <std::size_t Capacity, overflow_policy Policy = overflow_policy::fail,
+          std::ranges::input_range R>
+auto to_fixed(R &&range) {
+  return detail::to_fixed_closure<Capacity, Policy>{}(std::forward<R>(range));
+}
+}  // namespace utils
+#endif
@@ -0,0 +1,251 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+// Read-mostly vector with one writer and up to MaxReaders registered
+// readers. Two versions are kept inline: readers see the published one
+// while the writer fills the other and publishes it with a single atomic
+// store, so nothing is allocated after construction.
+//
+// Reclamation is epoch based. Taking a snapshot stamps the reader's slot
+// with the current epoch before loading the published version; publishing
+// advances the epoch. Before the writer reuses the retired version it waits
+// until no slot carries an epoch older than that publication. Readers
+// therefore never wait, and the writer waits only for snapshots that
+// started before its previous publication.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders = 64>
+class rcu_fixed_vector {
+  public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using vector_type = fixed_size_vector<T, Capacity>;
+
+  class snapshot;
+  class reader;
+
+  rcu_fixed_vector() = default;
+  rcu_fixed_vector(const rcu_fixed_vector &) = delete;
+  rcu_fixed_vector &operator=(const rcu_fixed_vector &) = delete;
+
+  static constexpr size_type capacity();
+  static constexpr size_type max_readers();
+
+  reader register_reader();
+
+  void publish(const vector_type &values);
+  template <typename Fn>
+  void update(Fn &&fn);
+  void synchronize();
+  std::uint64_t version() const;
+
+  private:
+  static constexpr std::uint64_t inactive{0};
+
+  struct alignas(64) reader_slot {
+    std::atomic<bool> claimed{false};
+    std::atomic<std::uint64_t> epoch{inactive};
+  };
+
+  vector_type versions[2];
+  alignas(64) std::atomic<unsigned> published{0};
+  std::atomic<std::uint64_t> epoch{1};
+  std::uint64_t retired_epoch{0};
+  reader_slot slots[MaxReaders];
+
+  vector_type &begin_write();
+  void end_write(unsigned next);
+  void wait_for_readers(std::uint64_t target) const;
+};
+
+// Consistent view of one published version. The version stays intact for
+// as long as the snapshot lives.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+class rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot {
+  public:
+  snapshot(snapshot &&other) noexcept;
+  snapshot &operator=(snapshot &&other) = delete;
+  snapshot(const snapshot &) = delete;
+  snapshot &operator=(const snapshot &) = delete;
+  ~snapshot();
+
+  const vector_type &operator*() const;
+  const vector_type *operator->() const;
+
+  private:
+  friend class reader;
+
+  snapshot(std::atomic<std::uint64_t> *slot_epoch, const vector_type *values);
+
+  std::atomic<std::uint64_t> *slot_epoch;
+  const vector_type *values;
+};
+
+// A registered reader owns one slot. Each thread should use its own reader,
+// and a reader holds at most one snapshot at a time.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+class rcu_fixed_vector<T, Capacity, MaxReaders>::reader {
+  public:
+  reader(reader &&other) noexcept;
+  reader &operator=(reader &&other) = delete;
+  reader(const reader &) = delete;
+  reader &operator=(const reader &) = delete;
+  ~reader();
+
+  snapshot read() const;
+
+  private:
+  friend class rcu_fixed_vector;
+
+  reader(const rcu_fixed_vector *owner, reader_slot *slot);
+
+  const rcu_fixed_vector *owner;
+  reader_slot *slot;
+};
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot::snapshot(
+    std::atomic<std::uint64_t> *slot_epoch, const vector_type *values)
+    : slot_epoch{slot_epoch}, values{values} {}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot::snapshot(
+    snapshot &&other) noexcept
+    : slot_epoch{other.slot_epoch}, values{other.values} {
+  other.slot_epoch = nullptr;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot::~snapshot() {
+  if (slot_epoch != nullptr) slot_epoch->store(inactive);
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+const typename rcu_fixed_vector<T, Capacity, MaxReaders>::vector_type &
+    rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot::operator*() const {
+  return *values;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+const typename rcu_fixed_vector<T, Capacity, MaxReaders>::vector_type *
+    rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot::operator->() const {
+  return values;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::reader::reader(
+    const rcu_fixed_vector *owner, reader_slot *slot)
+    : owner{owner}, slot{slot} {}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::reader::reader(
+    reader &&other) noexcept
+    : owner{other.owner}, slot{other.slot} {
+  other.slot = nullptr;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+rcu_fixed_vector<T, Capacity, MaxReaders>::reader::~reader() {
+  if (slot != nullptr) slot->claimed.store(false);
+}
+
+// Wait-free: one store to the reader's own slot and two loads.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+typename rcu_fixed_vector<T, Capacity, MaxReaders>::snapshot
+rcu_fixed_vector<T, Capacity, MaxReaders>::reader::read() const {
+  slot->epoch.store(owner->epoch.load());
+  return snapshot{&slot->epoch, &owner->versions[owner->published.load()]};
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+constexpr typename rcu_fixed_vector<T, Capacity, MaxReaders>::size_type
+rcu_fixed_vector<T, Capacity, MaxReaders>::capacity() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+constexpr typename rcu_fixed_vector<T, Capacity, MaxReaders>::size_type
+rcu_fixed_vector<T, Capacity, MaxReaders>::max_readers() {
+  return MaxReaders;
+}
+
+// Claims a free reader slot. Throws std::bad_alloc when all MaxReaders slots
+// are taken.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+typename rcu_fixed_vector<T, Capacity, MaxReaders>::reader
+rcu_fixed_vector<T, Capacity, MaxReaders>::register_reader() {
+  for (reader_slot &slot : slots) {
+    bool expected{false};
+    if (slot.claimed.compare_exchange_strong(expected, true)) {
+      return reader{this, &slot};
+    }
+  }
+  throw std::bad_alloc{};
+}
+
+// Replaces the contents. Only one thread may write at a time.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+void rcu_fixed_vector<T, Capacity, MaxReaders>::publish(
+    const vector_type &values) {
+  vector_type &next = begin_write();
+  next = values;
+  end_write(static_cast<unsigned>(&next - versions));
+}
+
+// Calls fn on a copy of the published version, then publishes the copy.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+template <typename Fn>
+void rcu_fixed_vector<T, Capacity, MaxReaders>::update(Fn &&fn) {
+  vector_type &next = begin_write();
+  next = versions[published.load(std::memory_order_relaxed)];
+  fn(next);
+  end_write(static_cast<unsigned>(&next - versions));
+}
+
+// Blocks until no reader can still see the version retired by the last
+// publication. Writers call this implicitly before reusing it.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+void rcu_fixed_vector<T, Capacity, MaxReaders>::synchronize() {
+  wait_for_readers(retired_epoch);
+}
+
+// Number of completed publications.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+std::uint64_t rcu_fixed_vector<T, Capacity, MaxReaders>::version() const {
+  return epoch.load() - 1;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+typename rcu_fixed_vector<T, Capacity, MaxReaders>::vector_type &
+rcu_fixed_vector<T, Capacity, MaxReaders>::begin_write() {
+  wait_for_readers(retired_epoch);
+  return versions[published.load(std::memory_order_relaxed) ^ 1u];
+}
+
+// A reader stamped with an epoch at or after the one returned by fetch_add
+// loaded that epoch after the new version was stored, so it cannot see the
+// retired one.
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+void rcu_fixed_vector<T, Capacity, MaxReaders>::end_write(
+    const unsigned next) {
+  published.store(next);
+  retired_epoch = epoch.fetch_add(1) + 1;
+}
+
+template <typename T, std::size_t Capacity, std::size_t MaxReaders>
+void rcu_fixed_vector<T, Capacity, MaxReaders>::wait_for_readers(
+    const std::uint64_t target) const {
+  for (const reader_slot &slot : slots) {
+    for (;;) {
+      const std::uint64_t seen = slot.epoch.load();
+      if (seen == inactive || seen >= target) break;
+      std::this_thread::yield();
+    }
+  }
+}
+}  // namespace utils
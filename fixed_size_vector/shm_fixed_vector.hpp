@@ -0,0 +1,274 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#define FIXED_SIZE_VECTOR_HAS_POSIX_SHM 1
+#endif
+
+#include "fixed_size_vector.hpp"
+
+namespace utils {
+// Layout description written at the start of every shared table. attach()
+// refuses a region whose header does not match the reader's own type, so
+// a stale or differently compiled writer is caught before any data is read.
+struct shm_header {
+  static constexpr std::uint64_t expected_magic{0x46535653484d0001ULL};
+  static constexpr std::uint32_t layout_version{1};
+
+  std::uint64_t magic;
+  std::uint32_t version;
+  std::uint32_t element_size;
+  std::uint64_t element_align;
+  std::uint64_t capacity;
+};
+
+// Single-writer, many-reader vector meant to live in memory shared between
+// processes. It holds no pointers, only a header, a sequence counter and
+// inline storage. Publication is a seqlock: the writer makes the counter
+// odd while it copies, and readers retry until they see the same even value
+// before and after their copy, so readers never block the writer or each
+// other.
+template <typename T, std::size_t Capacity>
+class shm_fixed_vector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "shm_fixed_vector requires a trivially copyable type");
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "shm_fixed_vector needs lock-free 64-bit atomics");
+
+  public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  static shm_fixed_vector *create(void *region, size_type region_size);
+  static shm_fixed_vector *attach(void *region, size_type region_size);
+  static constexpr size_type region_size();
+  static constexpr size_type capacity();
+
+  shm_fixed_vector(const shm_fixed_vector &) = delete;
+  shm_fixed_vector &operator=(const shm_fixed_vector &) = delete;
+
+  void publish(const value_type *values, size_type count);
+  template <std::size_t N>
+  void publish(const fixed_size_vector<value_type, N> &values);
+
+  size_type read(value_type *out, size_type max_count) const;
+  std::uint64_t generation() const;
+
+  private:
+  using storage_type = typename std::aligned_storage<sizeof(value_type),
+                                                     alignof(value_type)>::type;
+
+  shm_header header;
+  alignas(64) std::atomic<std::uint64_t> sequence{0};
+  std::atomic<std::uint64_t> current_size{0};
+  alignas(64) storage_type storage[Capacity];
+
+  shm_fixed_vector();
+  static void check_region(void *region, size_type region_size);
+};
+
+template <typename T, std::size_t Capacity>
+shm_fixed_vector<T, Capacity>::shm_fixed_vector()
+    : header{shm_header::expected_magic, shm_header::layout_version,
+             static_cast<std::uint32_t>(sizeof(value_type)),
+             alignof(value_type), Capacity} {}
+
+// Initializes a fresh table in region; call once, from the writer.
+template <typename T, std::size_t Capacity>
+shm_fixed_vector<T, Capacity> *shm_fixed_vector<T, Capacity>::create(
+    void *region, const size_type region_size) {
+  check_region(region, region_size);
+  return new (region) shm_fixed_vector;
+}
+
+template <typename T, std::size_t Capacity>
+shm_fixed_vector<T, Capacity> *shm_fixed_vector<T, Capacity>::attach(
+    void *region, const size_type region_size) {
+  check_region(region, region_size);
+  const auto *header = static_cast<const shm_header *>(region);
+  if (header->magic != shm_header::expected_magic) {
+    throw std::runtime_error{"shm_fixed_vector: bad magic"};
+  }
+  if (header->version != shm_header::layout_version) {
+    throw std::runtime_error{"shm_fixed_vector: unsupported layout version"};
+  }
+  if (header->element_size != sizeof(value_type) ||
+      header->element_align != alignof(value_type) ||
+      header->capacity != Capacity) {
+    throw std::runtime_error{"shm_fixed_vector: element layout mismatch"};
+  }
+  return std::launder(reinterpret_cast<shm_fixed_vector *>(region));
+}
+
+template <typename T, std::size_t Capacity>
+constexpr typename shm_fixed_vector<T, Capacity>::size_type
+shm_fixed_vector<T, Capacity>::region_size() {
+  return sizeof(shm_fixed_vector);
+}
+
+template <typename T, std::size_t Capacity>
+constexpr typename shm_fixed_vector<T, Capacity>::size_type
+shm_fixed_vector<T, Capacity>::capacity() {
+  return Capacity;
+}
+
+template <typename T, std::size_t Capacity>
+void shm_fixed_vector<T, Capacity>::publish(const value_type *values,
+                                            const size_type count) {
+  if (count > Capacity) throw std::bad_alloc{};
+  const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+  sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  if (count != 0) std::memcpy(storage, values, count * sizeof(value_type));
+  current_size.store(count, std::memory_order_relaxed);
+  sequence.store(seq + 2, std::memory_order_release);
+}
+
+template <typename T, std::size_t Capacity>
+template <std::size_t N>
+void shm_fixed_vector<T, Capacity>::publish(
+    const fixed_size_vector<value_type, N> &values) {
+  publish(values.data(), values.size());
+}
+
+// Copies a consistent snapshot of at most max_count elements into out and
+// returns the published size, which may exceed max_count.
+template <typename T, std::size_t Capacity>
+typename shm_fixed_vector<T, Capacity>::size_type
+shm_fixed_vector<T, Capacity>::read(value_type *out,
+                                    const size_type max_count) const {
+  for (;;) {
+    const std::uint64_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1u) continue;
+    const auto count =
+        static_cast<size_type>(current_size.load(std::memory_order_relaxed));
+    const size_type copied = count < max_count ? count : max_count;
+    if (copied != 0) std::memcpy(out, storage, copied * sizeof(value_type));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == before) return count;
+  }
+}
+
+// Number of completed publications.
+template <typename T, std::size_t Capacity>
+std::uint64_t shm_fixed_vector<T, Capacity>::generation() const {
+  return sequence.load(std::memory_order_acquire) / 2;
+}
+
+template <typename T, std::size_t Capacity>
+void shm_fixed_vector<T, Capacity>::check_region(void *region,
+                                                 const size_type region_size) {
+  if (region_size < sizeof(shm_fixed_vector)) {
+    throw std::invalid_argument{"shm_fixed_vector: region too small"};
+  }
+  if (reinterpret_cast<std::uintptr_t>(region) % alignof(shm_fixed_vector)) {
+    throw std::invalid_argument{"shm_fixed_vector: region misaligned"};
+  }
+}
+
+#if defined(FIXED_SIZE_VECTOR_HAS_POSIX_SHM)
+// Owns one shm_open/mmap mapping. Mappings are page aligned, which satisfies
+// shm_fixed_vector's alignment.
+class shm_region {
+  public:
+  static shm_region create(const std::string &name, std::size_t size);
+  static shm_region open(const std::string &name);
+  static void unlink(const std::string &name);
+
+  shm_region(shm_region &&other) noexcept;
+  shm_region &operator=(shm_region &&other) noexcept;
+  shm_region(const shm_region &) = delete;
+  shm_region &operator=(const shm_region &) = delete;
+  ~shm_region();
+
+  void *data() const;
+  std::size_t size() const;
+
+  private:
+  shm_region(void *address, std::size_t size);
+  static shm_region map(int fd, std::size_t size);
+
+  void *address{nullptr};
+  std::size_t length{0};
+};
+
+inline shm_region::shm_region(void *address, std::size_t size)
+    : address{address}, length{size} {}
+
+inline shm_region::shm_region(shm_region &&other) noexcept
+    : address{other.address}, length{other.length} {
+  other.address = nullptr;
+  other.length = 0;
+}
+
+inline shm_region &shm_region::operator=(shm_region &&other) noexcept {
+  if (this == &other) return *this;
+  if (address != nullptr) munmap(address, length);
+  address = other.address;
+  length = other.length;
+  other.address = nullptr;
+  other.length = 0;
+  return *this;
+}
+
+inline shm_region::~shm_region() {
+  if (address != nullptr) munmap(address, length);
+}
+
+inline shm_region shm_region::create(const std::string &name,
+                                     std::size_t size) {
+  const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0) throw std::system_error{errno, std::generic_category()};
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    const int error = errno;
+    close(fd);
+    throw std::system_error{error, std::generic_category()};
+  }
+  return map(fd, size);
+}
+
+inline shm_region shm_region::open(const std::string &name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) throw std::system_error{errno, std::generic_category()};
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    const int error = errno;
+    close(fd);
+    throw std::system_error{error, std::generic_category()};
+  }
+  return map(fd, static_cast<std::size_t>(info.st_size));
+}
+
+inline void shm_region::unlink(const std::string &name) {
+  shm_unlink(name.c_str());
+}
+
+inline shm_region shm_region::map(int fd, std::size_t size) {
+  void *address =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (address == MAP_FAILED) {
+    throw std::system_error{error, std::generic_category()};
+  }
+  return shm_region{address, size};
+}
+
+inline void *shm_region::data() const { return address; }
+
+inline std::size_t shm_region::size() const { return length; }
+#endif
+}  // namespace utils
@@ -0,0 +1,206 @@
+#include "stdafx.h"
+
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__cpp_lib_memory_resource)
+#include <memory_resource>
+#endif
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+namespace {
+// Counts allocations of pointer arrays, which is what the chunk table and
+// the chunk pool request.
+template <typename T>
+struct TableCountingAllocator {
+  using value_type = T;
+
+  explicit TableCountingAllocator(std::size_t *table_allocations)
+      : table_allocations{table_allocations} {}
+  template <typename U>
+  TableCountingAllocator(const TableCountingAllocator<U> &other)
+      : table_allocations{other.table_allocations} {}
+
+  T *allocate(std::size_t count) {
+    if constexpr (std::is_pointer_v<T>) ++*table_allocations;
+    return std::allocator<T>{}.allocate(count);
+  }
+  void deallocate(T *p, std::size_t count) {
+    std::allocator<T>{}.deallocate(p, count);
+  }
+
+  std::size_t *table_allocations;
+};
+
+template <typename T, typename U>
+bool operator==(const TableCountingAllocator<T> &lhs,
+                const TableCountingAllocator<U> &rhs) {
+  return lhs.table_allocations == rhs.table_allocations;
+}
+
+template <typename T, typename U>
+bool operator!=(const TableCountingAllocator<T> &lhs,
+                const TableCountingAllocator<U> &rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace
+
+TEST_CLASS(chunked_vector) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::chunked_vector<int, 4> sut;
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(0), sut.capacity());
+    Assert::AreEqual(std::size_t(4), sut.chunk_capacity());
+    Assert::IsTrue(sut.begin() == sut.end());
+  }
+  TEST_METHOD(initializerListConstructor) {
+    utils::chunked_vector<int, 2> sut{1, 2, 3};
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::AreEqual(std::size_t(2), sut.chunk_count());
+    Assert::AreEqual(1, sut.front());
+    Assert::AreEqual(3, sut.back());
+  }
+  TEST_METHOD(push_back_keeps_references_stable) {
+    utils::chunked_vector<std::string, 3> sut;
+    sut.push_back("first");
+    const std::string *first = &sut[0];
+    for (int i = 0; i < 100; ++i) sut.emplace_back(std::to_string(i));
+    Assert::IsTrue(first == &sut[0]);
+    Assert::AreEqual(std::string("first"), *first);
+    Assert::AreEqual(std::size_t(101), sut.size());
+    Assert::AreEqual(std::size_t(34), sut.chunk_count());
+    Assert::AreEqual(std::string("99"), sut.at(100));
+  }
+  TEST_METHOD(at_throws_out_of_range) {
+    utils::chunked_vector<int, 4> sut{1};
+    Assert::ExpectException<std::out_of_range>([&]() { sut.at(1); });
+  }
+  TEST_METHOD(iterators) {
+    utils::chunked_vector<int, 3> sut;
+    for (int i = 0; i < 10; ++i) sut.push_back(i);
+    Assert::AreEqual(45, std::accumulate(sut.begin(), sut.end(), 0));
+    Assert::AreEqual(std::ptrdiff_t(10), sut.end() - sut.begin());
+    Assert::AreEqual(7, sut.begin()[7]);
+    utils::chunked_vector<int, 3>::const_iterator iter = sut.begin() + 4;
+    Assert::AreEqual(4, *iter);
+    Assert::AreEqual(std::size_t(4), iter.index());
+  }
+  TEST_METHOD(pop_back_recycles_chunks) {
+    utils::chunked_vector<int, 2> sut{1, 2, 3};
+    sut.pop_back();
+    Assert::AreEqual(std::size_t(1), sut.chunk_count());
+    Assert::AreEqual(std::size_t(1), sut.pooled_chunk_count());
+    sut.push_back(4);
+    Assert::AreEqual(std::size_t(0), sut.pooled_chunk_count());
+    Assert::AreEqual(4, sut.back());
+  }
+  TEST_METHOD(clear_and_shrink_to_fit) {
+    utils::chunked_vector<int, 4> sut;
+    for (int i = 0; i < 10; ++i) sut.push_back(i);
+    sut.clear();
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(3), sut.pooled_chunk_count());
+    Assert::AreEqual(std::size_t(12), sut.capacity());
+    sut.shrink_to_fit();
+    Assert::AreEqual(std::size_t(0), sut.capacity());
+  }
+  TEST_METHOD(reserve) {
+    utils::chunked_vector<int, 4> sut;
+    sut.reserve(9);
+    Assert::AreEqual(std::size_t(12), sut.capacity());
+    Assert::AreEqual(std::size_t(0), sut.chunk_count());
+    for (int i = 0; i < 12; ++i) sut.push_back(i);
+    Assert::AreEqual(std::size_t(0), sut.pooled_chunk_count());
+  }
+  TEST_METHOD(chunk_table_grows_geometrically) {
+    std::size_t table_allocations{0};
+    utils::chunked_vector<int, 1, TableCountingAllocator<int>> sut{
+        TableCountingAllocator<int>{&table_allocations}};
+    for (int i = 0; i < 100000; ++i) sut.push_back(i);
+    Assert::AreEqual(std::size_t(100000), sut.chunk_count());
+    Assert::IsTrue(table_allocations <= 2 * 17);
+    Assert::AreEqual(99999, sut.back());
+  }
+  TEST_METHOD(destruction_does_not_grow_the_pool) {
+    std::size_t table_allocations{0};
+    {
+      utils::chunked_vector<int, 4, TableCountingAllocator<int>> sut{
+          TableCountingAllocator<int>{&table_allocations}};
+      for (int i = 0; i < 10; ++i) sut.push_back(i);
+      utils::chunked_vector<int, 4, TableCountingAllocator<int>> target{
+          TableCountingAllocator<int>{&table_allocations}};
+      target.push_back(1);
+      table_allocations = 0;
+      target = std::move(sut);
+      Assert::AreEqual(std::size_t(10), target.size());
+    }
+    Assert::AreEqual(std::size_t(0), table_allocations);
+  }
+  TEST_METHOD(for_each_chunk) {
+    utils::chunked_vector<int, 4> sut;
+    for (int i = 0; i < 10; ++i) sut.push_back(i);
+    std::vector<std::size_t> counts;
+    int sum = 0;
+    const auto &view = sut;
+    view.for_each_chunk([&](const int *data, std::size_t count) {
+      counts.push_back(count);
+      for (std::size_t i = 0; i < count; ++i) sum += data[i];
+    });
+    Assert::IsTrue(counts == std::vector<std::size_t>{4, 4, 2});
+    Assert::AreEqual(45, sum);
+    sut.for_each_chunk([](int *data, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) data[i] *= 2;
+    });
+    Assert::AreEqual(18, sut[9]);
+  }
+  TEST_METHOD(copy_and_move) {
+    utils::chunked_vector<std::string, 2> sut{"a", "b", "c"};
+    auto copy = sut;
+    copy.push_back("d");
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::AreEqual(std::string("c"), copy[2]);
+    auto moved = std::move(copy);
+    Assert::AreEqual(std::size_t(4), moved.size());
+    Assert::IsTrue(copy.empty());
+    sut = moved;
+    Assert::AreEqual(std::string("d"), sut.back());
+    utils::chunked_vector<std::string, 2> other{"x"};
+    swap(sut, other);
+    Assert::AreEqual(std::size_t(1), sut.size());
+    Assert::AreEqual(std::size_t(4), other.size());
+  }
+#if defined(__cpp_lib_memory_resource)
+  TEST_METHOD(move_assignment_between_resources_moves_elements) {
+    using sutType = utils::chunked_vector<std::string, 2,
+                                          std::pmr::polymorphic_allocator<int>>;
+    utils::fixed_size_arena<8192> source_arena;
+    utils::fixed_size_arena<8192> target_arena;
+    sutType sut{{"a", "b", "moved across resources"}, &source_arena};
+    sutType target{{"x"}, &target_arena};
+    target = std::move(sut);
+    Assert::AreEqual(std::size_t(3), target.size());
+    Assert::AreEqual(std::string("moved across resources"), target[2]);
+    Assert::IsTrue(target_arena.owns(&target[2]));
+  }
+  TEST_METHOD(move_assignment_within_resource_takes_chunks) {
+    using sutType =
+        utils::chunked_vector<int, 2, std::pmr::polymorphic_allocator<int>>;
+    utils::fixed_size_arena<4096> arena;
+    sutType sut{{1, 2, 3}, &arena};
+    const int *element = &sut[2];
+    sutType target{{4}, &arena};
+    target = std::move(sut);
+    Assert::IsTrue(element == &target[2]);
+    Assert::IsTrue(sut.empty());
+    sutType other{{5}, &arena};
+    swap(target, other);
+    Assert::AreEqual(std::size_t(3), other.size());
+    Assert::AreEqual(5, target[0]);
+  }
+#endif
+};
+}  // namespace fixed_size_vector_UT
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+
+#if defined(__cpp_lib_memory_resource)
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_arena) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::fixed_size_arena<256> sut;
+    Assert::AreEqual(std::size_t(256), sut.capacity());
+    Assert::AreEqual(std::size_t(0), sut.used());
+    Assert::IsTrue(sut.upstream_resource() == std::pmr::new_delete_resource());
+  }
+  TEST_METHOD(pmr_containers_allocate_inline) {
+    utils::fixed_size_arena<4096> sut{std::pmr::null_memory_resource()};
+    std::pmr::vector<int> values{&sut};
+    values.reserve(32);
+    for (int i = 0; i < 32; ++i) values.push_back(i);
+    Assert::IsTrue(sut.owns(values.data()));
+    std::pmr::map<int, std::pmr::string> names{&sut};
+    names.emplace(1, "a string long enough to skip the small buffer");
+    Assert::IsTrue(sut.owns(names.at(1).data()));
+    Assert::AreEqual(std::size_t(0), sut.statistics().upstream_allocations);
+  }
+  TEST_METHOD(alignment) {
+    utils::fixed_size_arena<256> sut;
+    void *first = sut.allocate(1, 1);
+    void *second = sut.allocate(8, 64);
+    Assert::IsTrue(first != second);
+    Assert::AreEqual(std::uintptr_t(0),
+                     reinterpret_cast<std::uintptr_t>(second) % 64);
+  }
+  TEST_METHOD(fail_fast_upstream_throws_bad_alloc) {
+    utils::fixed_size_arena<64> sut{std::pmr::null_memory_resource()};
+    Assert::IsTrue(sut.owns(sut.allocate(48)));
+    Assert::ExpectException<std::bad_alloc>(
+        [&]() { Assert::IsTrue(sut.allocate(32) == nullptr); });
+  }
+  TEST_METHOD(heap_upstream_fallback) {
+    utils::fixed_size_arena<64> sut;
+    void *p = sut.allocate(128, 8);
+    Assert::IsFalse(sut.owns(p));
+    Assert::AreEqual(std::size_t(1), sut.statistics().upstream_allocations);
+    Assert::AreEqual(std::size_t(128), sut.statistics().upstream_bytes);
+    sut.deallocate(p, 128, 8);
+    Assert::AreEqual(std::size_t(0), sut.statistics().deallocations);
+  }
+  TEST_METHOD(deallocating_last_block_rolls_back) {
+    utils::fixed_size_arena<256> sut;
+    void *first = sut.allocate(32, 8);
+    void *second = sut.allocate(32, 8);
+    sut.deallocate(first, 32, 8);
+    Assert::AreEqual(std::size_t(64), sut.used());
+    sut.deallocate(second, 32, 8);
+    Assert::AreEqual(std::size_t(32), sut.used());
+    Assert::IsTrue(sut.allocate(32, 8) == second);
+    Assert::AreEqual(std::size_t(64), sut.statistics().peak_bytes);
+  }
+  TEST_METHOD(size_classes_recycle_freed_blocks) {
+    utils::fixed_size_arena<1024> sut{utils::arena_reuse::size_classes};
+    void *first = sut.allocate(20, 8);
+    Assert::IsTrue(sut.owns(sut.allocate(20, 8)));
+    Assert::AreEqual(std::size_t(64), sut.used());
+    sut.deallocate(first, 20, 8);
+    Assert::IsTrue(sut.allocate(30, 8) == first);
+    Assert::AreEqual(std::size_t(1), sut.statistics().recycled);
+    Assert::AreEqual(std::size_t(64), sut.used());
+  }
+  TEST_METHOD(size_classes_under_churn) {
+    utils::fixed_size_arena<8192> sut{std::pmr::null_memory_resource(),
+                                      utils::arena_reuse::size_classes};
+    for (int round = 0; round < 100; ++round) {
+      std::pmr::vector<std::pmr::string> words{&sut};
+      for (int i = 0; i < 8; ++i) {
+        words.emplace_back("word number " + std::to_string(i) +
+                           " with enough text to allocate");
+      }
+    }
+    Assert::IsTrue(sut.statistics().recycled > 0);
+    Assert::AreEqual(sut.statistics().allocations,
+                     sut.statistics().deallocations);
+  }
+  TEST_METHOD(release) {
+    utils::fixed_size_arena<128> sut;
+    Assert::IsTrue(sut.owns(sut.allocate(100)));
+    sut.release();
+    Assert::AreEqual(std::size_t(0), sut.used());
+    Assert::AreEqual(std::size_t(128), sut.remaining());
+  }
+  TEST_METHOD(is_equal) {
+    utils::fixed_size_arena<64> sut;
+    utils::fixed_size_arena<64> other;
+    Assert::IsTrue(sut.is_equal(sut));
+    Assert::IsFalse(sut.is_equal(other));
+  }
+};
+}  // namespace fixed_size_vector_UT
+#endif
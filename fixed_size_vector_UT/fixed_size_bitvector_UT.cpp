@@ -0,0 +1,161 @@
+#include "stdafx.h"
+
+#include <bitset>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_bitvector) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::fixed_size_bitvector<100> sut;
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(100), sut.capacity());
+    Assert::AreEqual(std::size_t(2), sut.word_count());
+  }
+  TEST_METHOD(packed_storage) {
+    Assert::IsTrue(sizeof(utils::fixed_size_bitvector<4096>) <=
+                   4096 / 8 + sizeof(std::size_t));
+  }
+  TEST_METHOD(initializerListConstructor) {
+    utils::fixed_size_bitvector<10> sut{true, false, true};
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::IsTrue(sut[0]);
+    Assert::IsFalse(sut[1]);
+    Assert::IsTrue(sut[2]);
+  }
+  TEST_METHOD(push_back_throws_bad_alloc) {
+    utils::fixed_size_bitvector<2> sut{true, true};
+    Assert::ExpectException<std::bad_alloc>([&]() { sut.push_back(false); });
+  }
+  TEST_METHOD(proxy_reference) {
+    utils::fixed_size_bitvector<10> sut{false, false};
+    sut[1] = true;
+    Assert::IsTrue(sut.test(1));
+    sut[0] = sut[1];
+    Assert::IsTrue(sut[0]);
+    sut[1].flip();
+    Assert::IsFalse(sut[1]);
+    sut.at(1) = true;
+    Assert::IsTrue(sut.back());
+  }
+  TEST_METHOD(pop_back_clears_bit) {
+    utils::fixed_size_bitvector<10> sut{true, true};
+    sut.pop_back();
+    Assert::AreEqual(std::size_t(1), sut.size());
+    Assert::AreEqual(std::size_t(1), sut.count());
+  }
+  TEST_METHOD(iterate) {
+    utils::fixed_size_bitvector<10> sut{true, false, true, true};
+    int set{0};
+    for (bool bit : sut) set += bit;
+    Assert::AreEqual(3, set);
+    for (auto bit : sut) bit = false;
+    Assert::IsTrue(sut.none());
+    Assert::AreEqual(std::ptrdiff_t(4), sut.end() - sut.begin());
+  }
+  TEST_METHOD(insert_across_words) {
+    utils::fixed_size_bitvector<200> sut;
+    std::vector<bool> expected;
+    for (int i = 0; i < 150; ++i) {
+      sut.push_back(i % 3 == 0);
+      expected.push_back(i % 3 == 0);
+    }
+    for (std::size_t pos : {0u, 63u, 64u, 100u, 152u}) {
+      sut.insert(sut.begin() + pos, true);
+      expected.insert(expected.begin() + pos, true);
+    }
+    Assert::AreEqual(expected.size(), sut.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      Assert::AreEqual(static_cast<bool>(expected[i]), sut.test(i));
+    }
+  }
+  TEST_METHOD(erase_across_words) {
+    utils::fixed_size_bitvector<200> sut;
+    std::vector<bool> expected;
+    for (int i = 0; i < 150; ++i) {
+      sut.push_back(i % 5 < 2);
+      expected.push_back(i % 5 < 2);
+    }
+    for (std::size_t pos : {0u, 63u, 64u, 100u, 145u}) {
+      auto ret = sut.erase(sut.begin() + pos);
+      expected.erase(expected.begin() + pos);
+      Assert::AreEqual(pos, ret.index());
+    }
+    Assert::AreEqual(expected.size(), sut.size());
+    std::size_t expected_count{0};
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      Assert::AreEqual(static_cast<bool>(expected[i]), sut.test(i));
+      expected_count += expected[i];
+    }
+    Assert::AreEqual(expected_count, sut.count());
+  }
+  TEST_METHOD(insert_throws_bad_alloc) {
+    utils::fixed_size_bitvector<1> sut{true};
+    Assert::ExpectException<std::bad_alloc>(
+        [&]() { sut.insert(sut.begin(), false); });
+  }
+  TEST_METHOD(count_matches_bitset) {
+    utils::fixed_size_bitvector<1000> sut;
+    std::bitset<1000> expected;
+    for (std::size_t i = 0; i < 1000; ++i) {
+      const bool bit = (i * 7919) % 13 < 4;
+      sut.push_back(bit);
+      expected[i] = bit;
+    }
+    Assert::AreEqual(expected.count(), sut.count());
+  }
+  TEST_METHOD(find_first_and_next) {
+    utils::fixed_size_bitvector<300> sut;
+    for (int i = 0; i < 300; ++i) sut.push_back(false);
+    Assert::AreEqual(utils::fixed_size_bitvector<300>::npos, sut.find_first());
+    sut.set(5);
+    sut.set(64);
+    sut.set(299);
+    Assert::AreEqual(std::size_t(5), sut.find_first());
+    Assert::AreEqual(std::size_t(64), sut.find_next(5));
+    Assert::AreEqual(std::size_t(299), sut.find_next(64));
+    Assert::AreEqual(utils::fixed_size_bitvector<300>::npos,
+                     sut.find_next(299));
+  }
+  TEST_METHOD(rank_and_select) {
+    utils::fixed_size_bitvector<300> sut;
+    for (int i = 0; i < 300; ++i) sut.push_back(i % 10 == 0);
+    Assert::AreEqual(std::size_t(0), sut.rank(0));
+    Assert::AreEqual(std::size_t(1), sut.rank(1));
+    Assert::AreEqual(std::size_t(7), sut.rank(64));
+    Assert::AreEqual(std::size_t(30), sut.rank(300));
+    Assert::AreEqual(std::size_t(0), sut.select(0));
+    Assert::AreEqual(std::size_t(70), sut.select(7));
+    Assert::AreEqual(std::size_t(290), sut.select(29));
+    Assert::AreEqual(utils::fixed_size_bitvector<300>::npos, sut.select(30));
+  }
+  TEST_METHOD(bitwise_operators) {
+    utils::fixed_size_bitvector<128> a{true, true, false, false};
+    utils::fixed_size_bitvector<128> b{true, false, true};
+    auto both = a & b;
+    auto either = a | b;
+    auto one = a ^ b;
+    Assert::AreEqual(std::size_t(4), both.size());
+    Assert::AreEqual(std::size_t(1), both.count());
+    Assert::AreEqual(std::size_t(3), either.count());
+    Assert::AreEqual(std::size_t(2), one.count());
+    Assert::IsTrue(one.test(1));
+    Assert::IsTrue(one.test(2));
+  }
+  TEST_METHOD(equality) {
+    utils::fixed_size_bitvector<128> a{true, false};
+    utils::fixed_size_bitvector<128> b{true, false};
+    utils::fixed_size_bitvector<128> c{true, false, false};
+    Assert::IsTrue(a == b);
+    Assert::IsTrue(a != c);
+  }
+  TEST_METHOD(clear) {
+    utils::fixed_size_bitvector<128> sut{true, true, true};
+    sut.clear();
+    Assert::IsTrue(sut.empty());
+    sut.push_back(false);
+    Assert::AreEqual(std::size_t(0), sut.count());
+  }
+};
+}  // namespace fixed_size_vector_UT
@@ -0,0 +1,118 @@
+#include "stdafx.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_priority_queue) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(0), sut.size());
+    Assert::AreEqual(std::size_t(10), sut.capacity());
+  }
+  TEST_METHOD(push_keeps_largest_on_top) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    sut.push(3);
+    sut.push(7);
+    sut.push(1);
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::AreEqual(7, sut.top());
+  }
+  TEST_METHOD(push_throws_bad_alloc) {
+    utils::fixed_size_priority_queue<int, 2> sut;
+    sut.push(1);
+    sut.push(2);
+    Assert::IsTrue(sut.full());
+    Assert::ExpectException<std::bad_alloc>([&]() { sut.push(3); });
+  }
+  TEST_METHOD(pop) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    for (int i : {5, 2, 9, 4}) sut.push(i);
+    sut.pop();
+    Assert::AreEqual(5, sut.top());
+    sut.pop();
+    Assert::AreEqual(4, sut.top());
+    sut.pop();
+    sut.pop();
+    Assert::IsTrue(sut.empty());
+  }
+  TEST_METHOD(custom_compare) {
+    utils::fixed_size_priority_queue<int, 10, std::greater<int>> sut;
+    for (int i : {5, 2, 9, 4}) sut.push(i);
+    Assert::AreEqual(2, sut.top());
+  }
+  TEST_METHOD(replace_top) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    for (int i : {5, 2, 9, 4}) sut.push(i);
+    sut.replace_top(3);
+    Assert::AreEqual(std::size_t(4), sut.size());
+    Assert::AreEqual(5, sut.top());
+  }
+  TEST_METHOD(heapify_from_range) {
+    std::vector<int> v{8, 3, 11, 0, 6, 2, 15, 7, 1, 9};
+    utils::fixed_size_priority_queue<int, 10> sut{v.begin(), v.end()};
+    Assert::AreEqual(std::size_t(10), sut.size());
+    Assert::AreEqual(15, sut.top());
+  }
+  TEST_METHOD(heapify_throws_bad_alloc) {
+    std::vector<int> v{1, 2, 3};
+    Assert::ExpectException<std::bad_alloc>([&]() {
+      utils::fixed_size_priority_queue<int, 2> sut{v.begin(), v.end()};
+    });
+  }
+  TEST_METHOD(drain_sorted) {
+    std::vector<int> v;
+    for (int i = 0; i < 100; ++i) v.push_back((i * 37) % 101);
+    utils::fixed_size_priority_queue<int, 100> sut{v.begin(), v.end()};
+    std::vector<int> out;
+    sut.drain_sorted(std::back_inserter(out));
+    std::sort(v.begin(), v.end(), std::greater<int>{});
+    Assert::IsTrue(out == v);
+    Assert::IsTrue(sut.empty());
+  }
+  TEST_METHOD(push_bounded_keeps_top_k) {
+    utils::fixed_size_priority_queue<int, 3, std::greater<int>> sut;
+    for (int i : {4, 1, 8, 3, 9, 2, 7}) sut.push_bounded(i);
+    Assert::AreEqual(std::size_t(3), sut.size());
+    std::vector<int> out;
+    sut.drain_sorted(std::back_inserter(out));
+    Assert::IsTrue(out == std::vector<int>{7, 8, 9});
+  }
+  TEST_METHOD(push_bounded_rejects_worse) {
+    utils::fixed_size_priority_queue<int, 2, std::greater<int>> sut;
+    Assert::IsTrue(sut.push_bounded(5));
+    Assert::IsTrue(sut.push_bounded(6));
+    Assert::IsFalse(sut.push_bounded(1));
+    Assert::IsTrue(sut.push_bounded(7));
+    Assert::AreEqual(6, sut.top());
+  }
+  TEST_METHOD(push_bounded_std_string) {
+    utils::fixed_size_priority_queue<std::string, 2, std::greater<std::string>>
+        sut;
+    for (const char *s : {"b", "d", "a", "c"}) sut.push_bounded(s);
+    Assert::AreEqual("c", sut.top().c_str());
+  }
+  TEST_METHOD(clear) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    sut.push(1);
+    sut.push(2);
+    sut.clear();
+    Assert::IsTrue(sut.empty());
+  }
+  TEST_METHOD(adl_swap) {
+    utils::fixed_size_priority_queue<int, 10> sut;
+    sut.push(1);
+    utils::fixed_size_priority_queue<int, 10> other;
+    other.push(5);
+    other.push(3);
+    swap(sut, other);
+    Assert::AreEqual(std::size_t(2), sut.size());
+    Assert::AreEqual(5, sut.top());
+    Assert::AreEqual(1, other.top());
+  }
+};
+}  // namespace fixed_size_vector_UT
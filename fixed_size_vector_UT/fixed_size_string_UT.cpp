@@ -0,0 +1,144 @@
+#include "stdafx.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_string) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::fixed_size_string<15> sut;
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(0), sut.size());
+    Assert::AreEqual("", sut.c_str());
+  }
+  TEST_METHOD(cStringConstructor) {
+    utils::fixed_size_string<15> sut{"hello"};
+    Assert::AreEqual(std::size_t(5), sut.size());
+    Assert::AreEqual("hello", sut.c_str());
+  }
+  TEST_METHOD(constructor_throws_bad_alloc) {
+    Assert::ExpectException<std::bad_alloc>(
+        []() { utils::fixed_size_string<3> sut{"hello"}; });
+  }
+  TEST_METHOD(size_fits_in_trailing_byte) {
+    Assert::AreEqual(std::size_t(16), sizeof(utils::fixed_size_string<15>));
+  }
+  TEST_METHOD(full_string_is_null_terminated) {
+    utils::fixed_size_string<5> sut{"hello"};
+    Assert::IsTrue(sut.full());
+    Assert::AreEqual(std::size_t(5), sut.size());
+    Assert::AreEqual("hello", sut.c_str());
+  }
+  TEST_METHOD(push_back_and_pop_back) {
+    utils::fixed_size_string<4> sut;
+    sut.push_back('a');
+    sut.push_back('b');
+    Assert::AreEqual("ab", sut.c_str());
+    sut.pop_back();
+    Assert::AreEqual("a", sut.c_str());
+    Assert::AreEqual(std::size_t(1), sut.size());
+  }
+  TEST_METHOD(push_back_throws_bad_alloc) {
+    utils::fixed_size_string<2> sut{"ab"};
+    Assert::ExpectException<std::bad_alloc>([&]() { sut.push_back('c'); });
+  }
+  TEST_METHOD(append) {
+    utils::fixed_size_string<15> sut{"foo"};
+    sut.append("bar");
+    sut += '!';
+    Assert::AreEqual("foobar!", sut.c_str());
+    Assert::ExpectException<std::bad_alloc>(
+        [&]() { sut.append("0123456789"); });
+  }
+  TEST_METHOD(at_throws) {
+    utils::fixed_size_string<15> sut{"abc"};
+    Assert::AreEqual('c', sut.at(2));
+    Assert::ExpectException<std::out_of_range>([&]() { sut.at(3); });
+  }
+  TEST_METHOD(clear) {
+    utils::fixed_size_string<15> sut{"abc"};
+    sut.clear();
+    Assert::IsTrue(sut.empty());
+    Assert::IsTrue(sut == utils::fixed_size_string<15>{});
+  }
+  TEST_METHOD(find_char) {
+    utils::fixed_size_string<63> sut{
+        "0123456789abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQ"};
+    Assert::AreEqual(std::size_t(0), sut.find('0'));
+    Assert::AreEqual(std::size_t(36), sut.find('0', 1));
+    Assert::AreEqual(std::size_t(62), sut.find('Q'));
+    Assert::AreEqual(utils::fixed_size_string<63>::npos, sut.find('R'));
+    Assert::AreEqual(utils::fixed_size_string<63>::npos, sut.find('a', 70));
+  }
+  TEST_METHOD(find_substring) {
+    utils::fixed_size_string<31> sut{"key=value;key=other"};
+    Assert::AreEqual(std::size_t(4), sut.find("value"));
+    Assert::AreEqual(std::size_t(10), sut.find("key", 1));
+    Assert::AreEqual(std::size_t(10), sut.rfind("key"));
+    Assert::AreEqual(std::size_t(13), sut.rfind('='));
+  }
+  TEST_METHOD(starts_with_ends_with) {
+    utils::fixed_size_string<15> sut{"log.tag"};
+    Assert::IsTrue(sut.starts_with("log."));
+    Assert::IsTrue(sut.starts_with('l'));
+    Assert::IsFalse(sut.starts_with("tag"));
+    Assert::IsTrue(sut.ends_with("tag"));
+    Assert::IsTrue(sut.ends_with('g'));
+    Assert::IsFalse(sut.ends_with("log.tag.long"));
+  }
+  TEST_METHOD(equality) {
+    utils::fixed_size_string<40> sut{"a symbol longer than sixteen"};
+    utils::fixed_size_string<40> same{"a symbol longer than sixteen"};
+    utils::fixed_size_string<40> other{"a symbol longer than sixteeN"};
+    Assert::IsTrue(sut == same);
+    Assert::IsTrue(sut != other);
+    Assert::IsTrue(sut == "a symbol longer than sixteen");
+    Assert::IsTrue(std::string_view{"abc"} != sut);
+  }
+  TEST_METHOD(ordering) {
+    utils::fixed_size_string<15> a{"abc"};
+    utils::fixed_size_string<15> b{"abd"};
+    utils::fixed_size_string<15> prefix{"ab"};
+    Assert::IsTrue(a < b);
+    Assert::IsTrue(prefix < a);
+    Assert::IsTrue(b >= a);
+    Assert::IsTrue(a.compare("abc") == 0);
+  }
+  TEST_METHOD(string_view_conversion) {
+    utils::fixed_size_string<15> sut{"view"};
+    std::string_view view = sut;
+    Assert::AreEqual(std::size_t(4), view.size());
+    Assert::IsTrue(view == "view");
+  }
+  TEST_METHOD(hash_matches_for_equal_strings) {
+    utils::fixed_size_string<31> sut{"symbol"};
+    utils::fixed_size_string<31> same{"sym"};
+    same.append("bol");
+    std::hash<utils::fixed_size_string<31>> hasher;
+    Assert::AreEqual(hasher(sut), hasher(same));
+  }
+  TEST_METHOD(hash_differs_across_words) {
+    std::hash<utils::fixed_size_string<31>> hasher;
+    std::unordered_set<std::string> texts;
+    std::unordered_set<std::size_t> hashes;
+    for (int i = 0; i < 4096; ++i) {
+      std::string text(24, 'x');
+      text[i % 24] = static_cast<char>('a' + i / 24 % 26);
+      text[(i * 7 + 3) % 24] = static_cast<char>('A' + i / 624);
+      texts.insert(text);
+      hashes.insert(hasher(utils::fixed_size_string<31>{text.c_str()}));
+    }
+    Assert::AreEqual(texts.size(), hashes.size());
+  }
+  TEST_METHOD(unordered_map_key) {
+    std::unordered_map<utils::fixed_size_string<15>, int> sut;
+    sut["AAPL"] = 1;
+    sut["MSFT"] = 2;
+    Assert::AreEqual(1, sut.at("AAPL"));
+    Assert::AreEqual(2, sut.at("MSFT"));
+  }
+};
+}  // namespace fixed_size_vector_UT
@@ -0,0 +1,149 @@
+#include "stdafx.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_unordered_map) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::fixed_size_unordered_map<int, int, 10> sut;
+    Assert::IsTrue(sut.empty());
+    Assert::AreEqual(std::size_t(10), sut.capacity());
+    Assert::IsTrue(sut.begin() == sut.end());
+  }
+  TEST_METHOD(insert_and_find) {
+    utils::fixed_size_unordered_map<int, std::string, 10> sut;
+    Assert::IsTrue(sut.insert({1, "one"}).second);
+    Assert::IsTrue(sut.try_emplace(2, "two").second);
+    Assert::IsFalse(sut.insert({1, "uno"}).second);
+    Assert::AreEqual(std::size_t(2), sut.size());
+    Assert::AreEqual(std::string("one"), sut.find(1)->second);
+    Assert::IsTrue(sut.find(3) == sut.end());
+    Assert::IsTrue(sut.contains(2));
+    Assert::AreEqual(std::size_t(0), sut.count(3));
+  }
+  TEST_METHOD(subscript_and_at) {
+    utils::fixed_size_unordered_map<std::string, int, 10> sut;
+    sut["a"] = 1;
+    ++sut["a"];
+    ++sut["b"];
+    Assert::AreEqual(2, sut.at("a"));
+    Assert::AreEqual(1, sut.at("b"));
+    const auto &view = sut;
+    Assert::ExpectException<std::out_of_range>([&]() { view.at("c"); });
+  }
+  TEST_METHOD(insert_throws_bad_alloc_when_full) {
+    utils::fixed_size_unordered_map<int, int, 3> sut;
+    for (int i = 0; i < 3; ++i) sut[i] = i;
+    Assert::IsFalse(sut.insert({0, 5}).second);
+    Assert::ExpectException<std::bad_alloc>([&]() { sut[3] = 3; });
+  }
+  TEST_METHOD(erase_keeps_iteration_dense) {
+    utils::fixed_size_unordered_map<int, int, 10> sut;
+    for (int i = 0; i < 5; ++i) sut[i] = i * 10;
+    Assert::AreEqual(std::size_t(1), sut.erase(1));
+    Assert::AreEqual(std::size_t(0), sut.erase(1));
+    Assert::AreEqual(std::size_t(4), sut.size());
+    Assert::AreEqual(std::size_t(4), std::size_t(sut.end() - sut.begin()));
+    int sum = 0;
+    for (const auto &item : sut) sum += item.second;
+    Assert::AreEqual(0 + 20 + 30 + 40, sum);
+    Assert::AreEqual(40, sut.at(4));
+  }
+  TEST_METHOD(clear) {
+    utils::fixed_size_unordered_map<int, int, 4> sut;
+    for (int i = 0; i < 4; ++i) sut[i] = i;
+    sut.clear();
+    Assert::IsTrue(sut.empty());
+    for (int i = 10; i < 14; ++i) sut[i] = i;
+    Assert::IsFalse(sut.contains(0));
+    Assert::AreEqual(13, sut.at(13));
+  }
+  TEST_METHOD(colliding_hash_with_churn) {
+    struct bad_hash {
+      std::size_t operator()(int) const { return 0; }
+    };
+    utils::fixed_size_unordered_map<int, int, 40, bad_hash> sut;
+    for (int i = 0; i < 40; ++i) sut[i] = i;
+    for (int i = 0; i < 40; i += 2) sut.erase(i);
+    for (int i = 0; i < 40; ++i) {
+      Assert::AreEqual(i % 2 == 1, sut.contains(i));
+    }
+    for (int i = 100; i < 120; ++i) sut[i] = i;
+    Assert::AreEqual(std::size_t(40), sut.size());
+    for (int i = 1; i < 40; i += 2) Assert::AreEqual(i, sut.at(i));
+  }
+  TEST_METHOD(matches_std_map_under_random_churn) {
+    utils::fixed_size_unordered_map<int, int, 200> sut;
+    std::map<int, int> expected;
+    std::mt19937 rng{7};
+    for (int step = 0; step < 20000; ++step) {
+      const int key = static_cast<int>(rng() % 400);
+      if (rng() % 2 == 0 && expected.size() < 200) {
+        sut[key] = step;
+        expected[key] = step;
+      } else {
+        Assert::AreEqual(expected.erase(key), sut.erase(key));
+      }
+    }
+    Assert::AreEqual(expected.size(), sut.size());
+    for (const auto &item : expected) {
+      Assert::AreEqual(item.second, sut.at(item.first));
+    }
+    for (const auto &item : sut) {
+      Assert::AreEqual(expected.at(item.first), item.second);
+    }
+  }
+  TEST_METHOD(copy) {
+    utils::fixed_size_unordered_map<int, std::string, 8> sut;
+    sut[1] = "one";
+    auto copy = sut;
+    copy[2] = "two";
+    Assert::AreEqual(std::size_t(1), sut.size());
+    Assert::AreEqual(std::string("one"), copy.at(1));
+    Assert::AreEqual(std::string("two"), copy.at(2));
+  }
+  TEST_METHOD(erase_moves_last_entry_into_hole) {
+    utils::fixed_size_unordered_map<std::string, std::string, 8> sut;
+    sut["a"] = std::string(32, 'a');
+    sut["b"] = std::string(32, 'b');
+    sut["c"] = std::string(32, 'c');
+    Assert::AreEqual(std::size_t(1), sut.erase(sut.begin()->first));
+    Assert::AreEqual(std::size_t(2), sut.size());
+    for (const auto &item : sut) {
+      Assert::AreEqual(std::string(32, item.first[0]), item.second);
+      Assert::AreEqual(item.second, sut.at(item.first));
+    }
+  }
+};
+
+TEST_CLASS(fixed_size_unordered_set) {
+  TEST_METHOD(insert_contains_erase) {
+    utils::fixed_size_unordered_set<std::string, 8> sut;
+    Assert::IsTrue(sut.insert("a").second);
+    Assert::IsTrue(sut.insert("b").second);
+    Assert::IsFalse(sut.insert("a").second);
+    Assert::AreEqual(std::size_t(2), sut.size());
+    Assert::IsTrue(sut.contains("b"));
+    Assert::AreEqual(std::string("b"), *sut.find("b"));
+    Assert::AreEqual(std::size_t(1), sut.erase("a"));
+    Assert::IsFalse(sut.contains("a"));
+    Assert::IsTrue(sut.find("a") == sut.end());
+  }
+  TEST_METHOD(iteration_is_read_only) {
+    using set_type = utils::fixed_size_unordered_set<int, 4>;
+    static_assert(
+        std::is_same_v<set_type::iterator, const int *>,
+        "set iterators must not allow changing keys");
+    set_type sut;
+    sut.insert(3);
+    sut.insert(4);
+    int sum = 0;
+    for (int key : sut) sum += key;
+    Assert::AreEqual(7, sum);
+  }
+};
+}  // namespace fixed_size_vector_UT
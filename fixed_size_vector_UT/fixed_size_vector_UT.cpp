@@ -1,6 +1,8 @@
 #include "stdafx.h"
 
 #include <list>
+#include <memory>
+#include <unordered_map>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -54,7 +56,26 @@ std::size_t ObjectCouter::move_constructed;
 std::size_t ObjectCouter::copy_assigned;
 std::size_t ObjectCouter::move_assigned;
 std::size_t ObjectCouter::destructed;
+// Equality ignores the second member, so equal keys can differ in bytes.
+struct PartialKey {
+  int id;
+  int ignored;
+};
+bool operator==(const PartialKey &lhs, const PartialKey &rhs) {
+  return lhs.id == rhs.id;
+}
+}  // namespace fixed_size_vector_UT
+
+namespace std {
+template <>
+struct hash<fixed_size_vector_UT::PartialKey> {
+  std::size_t operator()(const fixed_size_vector_UT::PartialKey &key) const {
+    return std::hash<int>{}(key.id);
+  }
+};
+}  // namespace std
 
+namespace fixed_size_vector_UT {
 TEST_CLASS(fixed_size_vector){
     TEST_METHOD(DefaultConstructor){utils::fixed_size_vector<int, 10> sut;
 }  // namespace fixed_size_vector_UT
@@ -611,6 +632,218 @@ TEST_METHOD(iterator_ctor_object_counter) {
   Assert::AreEqual(std::size_t(3), ObjectCouter::copy_constructed);
   Assert::AreEqual(std::size_t(3), sut.size());
 }
+TEST_METHOD(swap_trivial_type) {
+  utils::fixed_size_vector<int, 10> sut{1, 2, 3};
+  utils::fixed_size_vector<int, 10> other{4, 5};
+  sut.swap(other);
+  Assert::AreEqual(std::size_t(2), sut.size());
+  Assert::AreEqual(std::size_t(3), other.size());
+  Assert::AreEqual(4, sut[0]);
+  Assert::AreEqual(5, sut[1]);
+  Assert::AreEqual(1, other[0]);
+  Assert::AreEqual(2, other[1]);
+  Assert::AreEqual(3, other[2]);
+}
+TEST_METHOD(swap_with_empty) {
+  utils::fixed_size_vector<int, 10> sut;
+  utils::fixed_size_vector<int, 10> other{1, 2, 3};
+  sut.swap(other);
+  Assert::AreEqual(std::size_t(3), sut.size());
+  Assert::IsTrue(other.empty());
+  Assert::AreEqual(3, sut[2]);
+}
+TEST_METHOD(swap_with_self) {
+  utils::fixed_size_vector<int, 10> sut{1, 2, 3};
+  sut.swap(sut);
+  Assert::AreEqual(std::size_t(3), sut.size());
+  Assert::AreEqual(1, sut[0]);
+  Assert::AreEqual(3, sut[2]);
+}
+TEST_METHOD(swap_std_string) {
+  utils::fixed_size_vector<std::string, 10> sut{"123"};
+  utils::fixed_size_vector<std::string, 10> other{"abc", "def", "ghi"};
+  sut.swap(other);
+  Assert::AreEqual(std::size_t(3), sut.size());
+  Assert::AreEqual(std::size_t(1), other.size());
+  Assert::AreEqual("abc", sut[0].c_str());
+  Assert::AreEqual("ghi", sut[2].c_str());
+  Assert::AreEqual("123", other[0].c_str());
+}
+TEST_METHOD(swap_object_counter) {
+  ObjectCouter::reset();
+  utils::fixed_size_vector<ObjectCouter, 10> sut;
+  sut.emplace_back(1);
+  utils::fixed_size_vector<ObjectCouter, 10> other;
+  other.emplace_back(2);
+  other.emplace_back(3);
+  other.emplace_back(4);
+  Assert::AreEqual(std::size_t(4), ObjectCouter::sum());
+  sut.swap(other);
+  Assert::AreEqual(std::size_t(3), sut.size());
+  Assert::AreEqual(std::size_t(1), other.size());
+  Assert::AreEqual(std::size_t(0), ObjectCouter::copy_constructed);
+  Assert::AreEqual(std::size_t(3), ObjectCouter::move_constructed);
+  Assert::AreEqual(std::size_t(2), ObjectCouter::move_assigned);
+  Assert::AreEqual(std::size_t(3), ObjectCouter::destructed);
+}
+TEST_METHOD(adl_swap) {
+  utils::fixed_size_vector<int, 10> sut{1, 2, 3};
+  utils::fixed_size_vector<int, 10> other{4};
+  using std::swap;
+  swap(sut, other);
+  Assert::AreEqual(std::size_t(1), sut.size());
+  Assert::AreEqual(4, sut[0]);
+  Assert::AreEqual(std::size_t(3), other.size());
+  Assert::IsTrue(noexcept(swap(sut, other)));
+}
+TEST_METHOD(copy_assign_replaces_contents) {
+  utils::fixed_size_vector<std::string, 10> sut{"123", "456", "789"};
+  utils::fixed_size_vector<std::string, 10> copy{"abc"};
+  copy = sut;
+  Assert::AreEqual(std::size_t(3), copy.size());
+  Assert::AreEqual("123", copy[0].c_str());
+}
+TEST_METHOD(copy_ctor_above_streaming_threshold) {
+  using sutType = utils::fixed_size_vector<int, (1 << 19) + 3>;
+  auto sut = std::make_unique<sutType>();
+  for (int i = 0; i < (1 << 19) + 3; ++i) sut->push_back(i);
+  auto copy = std::make_unique<sutType>(*sut);
+  Assert::AreEqual(sut->size(), copy->size());
+  Assert::AreEqual(0, (*copy)[0]);
+  Assert::AreEqual(12345, (*copy)[12345]);
+  Assert::AreEqual((1 << 19) + 2, copy->back());
+}
+TEST_METHOD(move_above_streaming_threshold) {
+  using sutType = utils::fixed_size_vector<int, (1 << 19) + 3>;
+  auto sut = std::make_unique<sutType>();
+  for (int i = 0; i < (1 << 19) + 3; ++i) sut->push_back(i);
+  auto moved = std::make_unique<sutType>(std::move(*sut));
+  Assert::AreEqual(std::size_t((1 << 19) + 3), moved->size());
+  Assert::AreEqual((1 << 19) + 2, moved->back());
+  *sut = std::move(*moved);
+  Assert::AreEqual(12345, (*sut)[12345]);
+}
+TEST_METHOD(copy_streaming) {
+  utils::fixed_size_vector<int, 1000> sut;
+  for (int i = 0; i < 999; ++i) sut.push_back(i);
+  utils::fixed_size_vector<int, 1000> copy{1, 2};
+  copy.copy_streaming(sut);
+  Assert::AreEqual(std::size_t(999), copy.size());
+  Assert::AreEqual(0, copy[0]);
+  Assert::AreEqual(998, copy[998]);
+}
+TEST_METHOD(fill_streaming) {
+  struct Frame {
+    char bytes[24];
+  };
+  utils::fixed_size_vector<Frame, 5000> sut;
+  Frame frame{};
+  frame.bytes[23] = 'x';
+  sut.fill_streaming(4321, frame);
+  Assert::AreEqual(std::size_t(4321), sut.size());
+  Assert::AreEqual('x', sut[0].bytes[23]);
+  Assert::AreEqual('x', sut[4320].bytes[23]);
+  Assert::ExpectException<std::bad_alloc>(
+      [&]() { sut.fill_streaming(5001, frame); });
+}
+TEST_METHOD(for_each_prefetched) {
+  utils::fixed_size_vector<int, 100> sut;
+  for (int i = 1; i <= 100; ++i) sut.push_back(i);
+  int sum{0};
+  sut.for_each_prefetched([&](int &i) { sum += i; }, 16);
+  Assert::AreEqual(5050, sum);
+  const auto &view = sut;
+  sum = 0;
+  view.for_each_prefetched([&](const int &i) { sum += i; });
+  Assert::AreEqual(5050, sum);
+}
+TEST_METHOD(iterator_ctor_pointer_range) {
+  const int values[]{1, 2, 3};
+  utils::fixed_size_vector<int, 10> sut{std::begin(values), std::end(values)};
+  Assert::AreEqual(std::size_t(3), sut.size());
+  Assert::AreEqual(3, sut[2]);
+}
+TEST_METHOD(iterator_ctor_throws_bad_alloc) {
+  std::list<int> v{1, 2, 3};
+  const int values[]{1, 2, 3};
+  Assert::ExpectException<std::bad_alloc>(
+      [&]() { utils::fixed_size_vector<int, 2> sut(v.begin(), v.end()); });
+  Assert::ExpectException<std::bad_alloc>([&]() {
+    utils::fixed_size_vector<int, 2> sut(std::begin(values), std::end(values));
+  });
+}
+TEST_METHOD(equality_trivial_type) {
+  utils::fixed_size_vector<std::uint8_t, 32> sut{1, 2, 3};
+  utils::fixed_size_vector<std::uint8_t, 32> same{1, 2, 3};
+  utils::fixed_size_vector<std::uint8_t, 32> other{1, 2, 4};
+  utils::fixed_size_vector<std::uint8_t, 32> shorter{1, 2};
+  Assert::IsTrue(sut == same);
+  Assert::IsTrue(sut != other);
+  Assert::IsTrue(sut != shorter);
+}
+TEST_METHOD(equality_std_string) {
+  utils::fixed_size_vector<std::string, 10> sut{"a", "b"};
+  utils::fixed_size_vector<std::string, 10> same{"a", "b"};
+  utils::fixed_size_vector<std::string, 10> other{"a", "c"};
+  Assert::IsTrue(sut == same);
+  Assert::IsFalse(sut == other);
+}
+TEST_METHOD(equality_double) {
+  utils::fixed_size_vector<double, 10> sut{0.0};
+  utils::fixed_size_vector<double, 10> negative_zero{-0.0};
+  Assert::IsTrue(sut == negative_zero);
+}
+TEST_METHOD(ordering_bytes) {
+  utils::fixed_size_vector<unsigned char, 10> sut{1, 200};
+  utils::fixed_size_vector<unsigned char, 10> greater{2};
+  utils::fixed_size_vector<unsigned char, 10> prefix{1};
+  Assert::IsTrue(sut < greater);
+  Assert::IsTrue(prefix < sut);
+  Assert::IsTrue(greater > sut);
+  Assert::IsTrue(sut <= sut);
+  Assert::IsTrue(sut >= prefix);
+}
+TEST_METHOD(ordering_signed) {
+  utils::fixed_size_vector<int, 10> sut{-1, 5};
+  utils::fixed_size_vector<int, 10> other{1};
+  Assert::IsTrue(sut < other);
+  Assert::IsFalse(other < sut);
+}
+#if defined(__cpp_lib_three_way_comparison)
+TEST_METHOD(three_way_comparison) {
+  utils::fixed_size_vector<unsigned char, 10> bytes{1, 2};
+  utils::fixed_size_vector<unsigned char, 10> more_bytes{1, 3};
+  Assert::IsTrue((bytes <=> more_bytes) < 0);
+  utils::fixed_size_vector<int, 10> ints{4};
+  Assert::IsTrue((ints <=> ints) == 0);
+}
+#endif
+TEST_METHOD(hash_equal_vectors) {
+  utils::fixed_size_vector<std::uint8_t, 32> sut{1, 2, 3};
+  utils::fixed_size_vector<std::uint8_t, 32> same{1, 2, 3};
+  std::hash<utils::fixed_size_vector<std::uint8_t, 32>> hasher;
+  Assert::AreEqual(hasher(sut), hasher(same));
+  std::hash<utils::fixed_size_vector<std::string, 4>> string_hasher;
+  Assert::AreEqual(string_hasher({"a", "b"}), string_hasher({"a", "b"}));
+}
+TEST_METHOD(hash_follows_custom_equality) {
+  using sutType = utils::fixed_size_vector<PartialKey, 4>;
+  const sutType sut{{1, 10}, {2, 20}};
+  const sutType same{{1, 11}, {2, 21}};
+  Assert::IsTrue(sut == same);
+  Assert::AreEqual(std::hash<sutType>{}(sut), std::hash<sutType>{}(same));
+  std::unordered_map<sutType, int> keys;
+  keys[sut] = 1;
+  keys[same] = 2;
+  Assert::AreEqual(std::size_t(1), keys.size());
+}
+TEST_METHOD(unordered_map_key) {
+  std::unordered_map<utils::fixed_size_vector<std::uint8_t, 32>, int> sut;
+  sut[{1, 2, 3}] = 1;
+  sut[{3, 2, 1}] = 2;
+  Assert::AreEqual(std::size_t(2), sut.size());
+  Assert::AreEqual(2, sut.at({3, 2, 1}));
+}
 }
 ;
 }  // namespace fixed_size_vector_UT
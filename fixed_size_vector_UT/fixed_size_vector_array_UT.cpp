@@ -0,0 +1,155 @@
+#include "stdafx.h"
+
+#include <string>
+#include <vector>
+#if defined(__cpp_lib_memory_resource)
+#include <memory_resource>
+#endif
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_vector_array) {
+  TEST_METHOD(Constructor) {
+    utils::fixed_size_vector_array<std::uint16_t, 8> sut{100};
+    Assert::AreEqual(std::size_t(100), sut.size());
+    Assert::AreEqual(std::size_t(8), sut.slot_capacity());
+    Assert::AreEqual(std::size_t(0), sut.total_size());
+    Assert::IsTrue(sut[42].empty());
+  }
+  TEST_METHOD(packed_size_type) {
+    using small = utils::fixed_size_vector_array<int, 8>;
+    using medium = utils::fixed_size_vector_array<int, 1000>;
+    Assert::IsTrue(std::is_same_v<small::slot_size_type, std::uint8_t>);
+    Assert::IsTrue(std::is_same_v<medium::slot_size_type, std::uint16_t>);
+  }
+  TEST_METHOD(slot_push_back) {
+    utils::fixed_size_vector_array<std::uint16_t, 8> sut{10};
+    auto slot = sut[3];
+    slot.push_back(1);
+    slot.push_back(2);
+    Assert::AreEqual(std::size_t(2), sut[3].size());
+    Assert::AreEqual(std::uint16_t(2), sut[3][1]);
+    Assert::AreEqual(std::uint8_t(2), sut.sizes()[3]);
+    Assert::IsTrue(sut[2].empty());
+    Assert::IsTrue(sut[4].empty());
+  }
+  TEST_METHOD(slot_push_back_throws_bad_alloc) {
+    utils::fixed_size_vector_array<int, 2> sut{1};
+    sut[0].push_back(1);
+    sut[0].push_back(2);
+    Assert::ExpectException<std::bad_alloc>([&]() { sut[0].push_back(3); });
+  }
+  TEST_METHOD(slot_range_based_for_loop) {
+    utils::fixed_size_vector_array<int, 8> sut{4};
+    for (int i : {1, 2, 3}) sut[1].push_back(i);
+    int sum{0};
+    for (int i : sut[1]) sum += i;
+    Assert::AreEqual(6, sum);
+  }
+  TEST_METHOD(slot_erase_and_pop_back) {
+    utils::fixed_size_vector_array<int, 8> sut{1};
+    auto slot = sut[0];
+    for (int i : {1, 2, 3, 4}) slot.push_back(i);
+    slot.erase(slot.begin() + 1);
+    Assert::AreEqual(std::size_t(3), slot.size());
+    Assert::AreEqual(3, slot[1]);
+    slot.pop_back();
+    Assert::AreEqual(3, slot.back());
+  }
+  TEST_METHOD(at_throws) {
+    utils::fixed_size_vector_array<int, 8> sut{2};
+    sut[1].push_back(5);
+    Assert::AreEqual(5, sut.at(1).at(0));
+    Assert::ExpectException<std::out_of_range>([&]() { sut.at(2); });
+    Assert::ExpectException<std::out_of_range>([&]() { sut.at(1).at(1); });
+  }
+  TEST_METHOD(const_slot) {
+    utils::fixed_size_vector_array<int, 8> sut{2};
+    sut[0].push_back(7);
+    const auto &view = sut;
+    Assert::AreEqual(7, view[0].front());
+    Assert::IsTrue(std::is_same_v<decltype(view[0].front()), const int &>);
+  }
+  TEST_METHOD(total_size) {
+    utils::fixed_size_vector_array<int, 8> sut{1000};
+    sut[0].push_back(1);
+    sut[500].push_back(1);
+    sut[500].push_back(2);
+    sut[999].push_back(3);
+    Assert::AreEqual(std::size_t(4), sut.total_size());
+  }
+  TEST_METHOD(for_each_nonempty) {
+    utils::fixed_size_vector_array<std::uint16_t, 300> sut{1000};
+    std::vector<std::size_t> expected{0, 17, 255, 256, 999};
+    for (std::size_t pos : expected) sut[pos].push_back(1);
+    std::vector<std::size_t> visited;
+    sut.for_each_nonempty([&](std::size_t pos, auto slot) {
+      Assert::AreEqual(std::size_t(1), slot.size());
+      visited.push_back(pos);
+    });
+    Assert::IsTrue(visited == expected);
+  }
+  TEST_METHOD(clear_all) {
+    utils::fixed_size_vector_array<std::string, 4> sut{64};
+    sut[3].push_back("a long string that does not fit in the SSO buffer");
+    sut[60].push_back("b");
+    sut.clear_all();
+    Assert::AreEqual(std::size_t(0), sut.total_size());
+    Assert::IsTrue(sut[3].empty());
+  }
+  TEST_METHOD(move_constructor) {
+    utils::fixed_size_vector_array<int, 8> sut{4};
+    sut[2].push_back(9);
+    auto moved{std::move(sut)};
+    Assert::AreEqual(std::size_t(4), moved.size());
+    Assert::AreEqual(9, moved[2][0]);
+    Assert::IsTrue(sut.empty());
+  }
+  TEST_METHOD(move_assignment) {
+    utils::fixed_size_vector_array<std::string, 8> sut{4};
+    sut[2].push_back("kept");
+    utils::fixed_size_vector_array<std::string, 8> target{1};
+    target[0].push_back("dropped");
+    target = std::move(sut);
+    Assert::AreEqual(std::size_t(4), target.size());
+    Assert::AreEqual(std::string("kept"), target[2][0]);
+  }
+#if defined(__cpp_lib_memory_resource)
+  TEST_METHOD(move_assignment_between_resources_moves_elements) {
+    using sutType =
+        utils::fixed_size_vector_array<std::string, 4,
+                                       std::pmr::polymorphic_allocator<int>>;
+    utils::fixed_size_arena<4096> source_arena;
+    utils::fixed_size_arena<4096> target_arena;
+    sutType sut{3, &source_arena};
+    sut[1].push_back("moved across resources");
+    sutType target{2, &target_arena};
+    target = std::move(sut);
+    Assert::AreEqual(std::size_t(3), target.size());
+    Assert::AreEqual(std::string("moved across resources"), target[1][0]);
+    Assert::IsTrue(target_arena.owns(&target[1][0]));
+  }
+  TEST_METHOD(move_assignment_within_resource_takes_storage) {
+    using sutType =
+        utils::fixed_size_vector_array<int, 4,
+                                       std::pmr::polymorphic_allocator<int>>;
+    utils::fixed_size_arena<4096> arena;
+    sutType sut{3, &arena};
+    sut[1].push_back(7);
+    const int *element = &sut[1][0];
+    sutType target{2, &arena};
+    target = std::move(sut);
+    Assert::IsTrue(element == &target[1][0]);
+    Assert::IsTrue(sut.empty());
+  }
+#endif
+  TEST_METHOD(huge_page_allocator) {
+    utils::fixed_size_vector_array<std::uint16_t, 8,
+                                   utils::huge_page_allocator<std::uint16_t>>
+        sut{1 << 16};
+    sut[(1 << 16) - 1].push_back(3);
+    Assert::AreEqual(std::size_t(1), sut.total_size());
+  }
+};
+}  // namespace fixed_size_vector_UT
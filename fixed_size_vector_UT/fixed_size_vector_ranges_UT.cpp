@@ -0,0 +1,73 @@
+#include "stdafx.h"
+
+#if defined(__cpp_lib_ranges)
+#include <list>
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(fixed_size_vector_ranges) {
+  TEST_METHOD(models_contiguous_range) {
+    using sutType = utils::fixed_size_vector<int, 10>;
+    Assert::IsTrue(std::ranges::contiguous_range<sutType>);
+    Assert::IsTrue(std::ranges::sized_range<sutType>);
+    Assert::IsTrue(std::ranges::contiguous_range<const sutType>);
+  }
+  TEST_METHOD(ranges_algorithms) {
+    utils::fixed_size_vector<int, 10> sut{3, 1, 2};
+    std::ranges::sort(sut);
+    Assert::AreEqual(1, sut[0]);
+    Assert::AreEqual(3, sut[2]);
+    Assert::AreEqual(std::size_t(3), std::ranges::size(sut));
+  }
+  TEST_METHOD(to_fixed_from_pipeline) {
+    std::vector<int> v{1, 2, 3, 4, 5, 6};
+    auto sut = v | std::views::filter([](int i) { return i % 2 == 0; }) |
+               std::views::transform([](int i) { return i * 10; }) |
+               utils::to_fixed<8>();
+    Assert::IsTrue(
+        std::is_same_v<decltype(sut), utils::fixed_size_vector<int, 8>>);
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::AreEqual(20, sut[0]);
+    Assert::AreEqual(60, sut[2]);
+  }
+  TEST_METHOD(to_fixed_from_contiguous_range) {
+    std::vector<int> v{1, 2, 3};
+    auto sut = utils::to_fixed<8>(v);
+    Assert::AreEqual(std::size_t(3), sut.size());
+    Assert::AreEqual(3, sut[2]);
+  }
+  TEST_METHOD(to_fixed_non_trivial_type) {
+    std::list<std::string> l{"a", "b"};
+    auto sut = l | utils::to_fixed<4>();
+    Assert::AreEqual(std::size_t(2), sut.size());
+    Assert::AreEqual("b", sut[1].c_str());
+  }
+  TEST_METHOD(to_fixed_fail_throws_bad_alloc) {
+    std::vector<int> v{1, 2, 3};
+    Assert::ExpectException<std::bad_alloc>(
+        [&]() { auto sut = v | utils::to_fixed<2>(); });
+    Assert::ExpectException<std::bad_alloc>([&]() {
+      auto sut = std::views::iota(0, 10) | utils::to_fixed<2>();
+    });
+  }
+  TEST_METHOD(to_fixed_truncate) {
+    auto sut = std::views::iota(0, 10) |
+               utils::to_fixed<4, utils::overflow_policy::truncate>();
+    Assert::AreEqual(std::size_t(4), sut.size());
+    Assert::AreEqual(3, sut.back());
+  }
+  TEST_METHOD(to_fixed_report) {
+    std::vector<int> v{1, 2, 3};
+    auto sut = v | utils::to_fixed<2, utils::overflow_policy::report>();
+    Assert::IsTrue(sut.truncated);
+    Assert::AreEqual(std::size_t(2), sut.values.size());
+    auto fits = v | utils::to_fixed<3, utils::overflow_policy::report>();
+    Assert::IsFalse(fits.truncated);
+  }
+};
+}  // namespace fixed_size_vector_UT
+#endif
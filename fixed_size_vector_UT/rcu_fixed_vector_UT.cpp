@@ -0,0 +1,85 @@
+#include "stdafx.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+TEST_CLASS(rcu_fixed_vector) {
+  TEST_METHOD(DefaultConstructor) {
+    utils::rcu_fixed_vector<int, 8, 4> sut;
+    auto reader = sut.register_reader();
+    Assert::IsTrue(reader.read()->empty());
+    Assert::AreEqual(std::uint64_t(0), sut.version());
+    Assert::AreEqual(std::size_t(8), sut.capacity());
+    Assert::AreEqual(std::size_t(4), sut.max_readers());
+  }
+  TEST_METHOD(publish_and_update) {
+    utils::rcu_fixed_vector<int, 8, 4> sut;
+    auto reader = sut.register_reader();
+    sut.publish({1, 2, 3});
+    Assert::AreEqual(std::size_t(3), reader.read()->size());
+    sut.update([](utils::fixed_size_vector<int, 8> &next) {
+      next.push_back(4);
+    });
+    const auto snapshot = reader.read();
+    Assert::AreEqual(std::size_t(4), snapshot->size());
+    Assert::AreEqual(4, (*snapshot)[3]);
+    Assert::AreEqual(std::uint64_t(2), sut.version());
+  }
+  TEST_METHOD(snapshot_outlives_publication) {
+    utils::rcu_fixed_vector<int, 8, 4> sut;
+    auto reader = sut.register_reader();
+    sut.publish({1});
+    {
+      const auto snapshot = reader.read();
+      sut.publish({2});
+      Assert::AreEqual(1, snapshot->front());
+    }
+    sut.publish({3});
+    Assert::AreEqual(3, reader.read()->front());
+  }
+  TEST_METHOD(register_reader_throws_bad_alloc_when_slots_run_out) {
+    utils::rcu_fixed_vector<int, 8, 2> sut;
+    auto first = sut.register_reader();
+    {
+      auto second = sut.register_reader();
+      Assert::ExpectException<std::bad_alloc>(
+          [&]() { auto third = sut.register_reader(); });
+    }
+    auto reused = sut.register_reader();
+    Assert::IsTrue(reused.read()->empty());
+  }
+  TEST_METHOD(readers_see_consistent_versions) {
+    using sutType = utils::rcu_fixed_vector<std::uint64_t, 64, 8>;
+    auto sut = std::make_unique<sutType>();
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+      readers.emplace_back([&]() {
+        auto reader = sut->register_reader();
+        while (!done.load()) {
+          const auto snapshot = reader.read();
+          for (std::size_t j = 1; j < snapshot->size(); ++j) {
+            if ((*snapshot)[j] != (*snapshot)[0]) consistent.store(false);
+          }
+        }
+      });
+    }
+    for (std::uint64_t round = 1; round <= 5000; ++round) {
+      sut->update([&](utils::fixed_size_vector<std::uint64_t, 64> &next) {
+        next.clear();
+        for (std::size_t i = 0; i < 1 + round % 64; ++i) next.push_back(round);
+      });
+    }
+    done.store(true);
+    for (auto &reader : readers) reader.join();
+    Assert::IsTrue(consistent.load());
+    Assert::AreEqual(std::uint64_t(5000), sut->version());
+  }
+};
+}  // namespace fixed_size_vector_UT
@@ -0,0 +1,119 @@
+#include "stdafx.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace fixed_size_vector_UT {
+namespace {
+struct Tick {
+  std::uint64_t id;
+  double price;
+};
+
+template <typename Table>
+struct aligned_region {
+  alignas(Table) unsigned char bytes[Table::region_size()];
+};
+}  // namespace
+
+TEST_CLASS(shm_fixed_vector) {
+  TEST_METHOD(publish_and_read) {
+    using sutType = utils::shm_fixed_vector<Tick, 16>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    auto *writer = sutType::create(region->bytes, sizeof(region->bytes));
+    const Tick ticks[]{{1, 10.5}, {2, 11.5}};
+    writer->publish(ticks, 2);
+    auto *reader = sutType::attach(region->bytes, sizeof(region->bytes));
+    Tick out[16];
+    Assert::AreEqual(std::size_t(2), reader->read(out, 16));
+    Assert::AreEqual(std::uint64_t(2), out[1].id);
+    Assert::AreEqual(std::uint64_t(1), reader->generation());
+  }
+  TEST_METHOD(publish_fixed_size_vector) {
+    using sutType = utils::shm_fixed_vector<int, 8>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    auto *sut = sutType::create(region->bytes, sizeof(region->bytes));
+    utils::fixed_size_vector<int, 8> values{1, 2, 3};
+    sut->publish(values);
+    int out[2];
+    Assert::AreEqual(std::size_t(3), sut->read(out, 2));
+    Assert::AreEqual(2, out[1]);
+  }
+  TEST_METHOD(publish_throws_bad_alloc) {
+    using sutType = utils::shm_fixed_vector<int, 2>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    auto *sut = sutType::create(region->bytes, sizeof(region->bytes));
+    const int values[]{1, 2, 3};
+    Assert::ExpectException<std::bad_alloc>(
+        [&]() { sut->publish(values, 3); });
+  }
+  TEST_METHOD(attach_rejects_layout_mismatch) {
+    using writerType = utils::shm_fixed_vector<int, 8>;
+    using readerType = utils::shm_fixed_vector<int, 16>;
+    auto region = std::make_unique<aligned_region<readerType>>();
+    writerType::create(region->bytes, sizeof(region->bytes));
+    Assert::ExpectException<std::runtime_error>([&]() {
+      readerType::attach(region->bytes, sizeof(region->bytes));
+    });
+  }
+  TEST_METHOD(attach_rejects_uninitialized_region) {
+    using sutType = utils::shm_fixed_vector<int, 8>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    Assert::ExpectException<std::runtime_error>(
+        [&]() { sutType::attach(region->bytes, sizeof(region->bytes)); });
+  }
+  TEST_METHOD(create_rejects_small_region) {
+    using sutType = utils::shm_fixed_vector<int, 8>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    Assert::ExpectException<std::invalid_argument>(
+        [&]() { sutType::create(region->bytes, 16); });
+  }
+  TEST_METHOD(readers_see_consistent_snapshots) {
+    using sutType = utils::shm_fixed_vector<std::uint64_t, 64>;
+    auto region = std::make_unique<aligned_region<sutType>>();
+    auto *sut = sutType::create(region->bytes, sizeof(region->bytes));
+    std::thread writer{[&]() {
+      std::uint64_t values[64];
+      for (std::uint64_t round = 1; round <= 20000; ++round) {
+        const std::size_t count = 1 + round % 64;
+        for (std::size_t i = 0; i < count; ++i) values[i] = round;
+        sut->publish(values, count);
+      }
+    }};
+    bool consistent{true};
+    std::uint64_t out[64];
+    for (int i = 0; i < 20000; ++i) {
+      const std::size_t count = sut->read(out, 64);
+      for (std::size_t j = 1; j < count; ++j) {
+        if (out[j] != out[0]) consistent = false;
+      }
+      if (count != 0 && count != 1 + out[0] % 64) consistent = false;
+    }
+    writer.join();
+    Assert::IsTrue(consistent);
+  }
+#if defined(FIXED_SIZE_VECTOR_HAS_POSIX_SHM)
+  TEST_METHOD(shm_region_shared_between_mappings) {
+    using sutType = utils::shm_fixed_vector<int, 32>;
+    const std::string name{"/fixed_size_vector_UT_shm_region"};
+    utils::shm_region::unlink(name);
+    auto writer_region =
+        utils::shm_region::create(name, sutType::region_size());
+    auto reader_region = utils::shm_region::open(name);
+    utils::shm_region::unlink(name);
+    auto *writer =
+        sutType::create(writer_region.data(), writer_region.size());
+    auto *reader =
+        sutType::attach(reader_region.data(), reader_region.size());
+    const int values[]{7, 8, 9};
+    writer->publish(values, 3);
+    int out[32];
+    Assert::AreEqual(std::size_t(3), reader->read(out, 32));
+    Assert::AreEqual(9, out[2]);
+  }
+#endif
+};
+}  // namespace fixed_size_vector_UT
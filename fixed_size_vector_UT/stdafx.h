@@ -2,3 +2,13 @@
 #include "CppUnitTest.h"
 
 #include "../fixed_size_vector/fixed_size_vector.hpp"
+#include "../fixed_size_vector/fixed_size_priority_queue.hpp"
+#include "../fixed_size_vector/fixed_size_string.hpp"
+#include "../fixed_size_vector/fixed_size_vector_array.hpp"
+#include "../fixed_size_vector/fixed_size_vector_ranges.hpp"
+#include "../fixed_size_vector/shm_fixed_vector.hpp"
+#include "../fixed_size_vector/fixed_size_bitvector.hpp"
+#include "../fixed_size_vector/fixed_size_unordered_map.hpp"
+#include "../fixed_size_vector/chunked_vector.hpp"
+#include "../fixed_size_vector/fixed_size_arena.hpp"
+#include "../fixed_size_vector/rcu_fixed_vector.hpp"